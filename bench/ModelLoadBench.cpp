@@ -0,0 +1,103 @@
+// Model load cost: Assimp import of the source file versus mapping the cooked
+// .fmesh. Both sides stop at a ModelData ready for upload; the fmesh side also
+// reads every vertex and index byte once, which is what glBufferData would do.
+//
+// usage: bench_model_load [model ...]
+// (run from the repo root so the default asset paths resolve)
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+
+#include "ModelImporter.h"
+#include "FMesh.h"
+
+namespace
+{
+    constexpr int RUNS = 10;
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    double elapsedMs(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // stands in for the driver copying the buffers
+    unsigned long long touch(const ModelData &data)
+    {
+        unsigned long long sum = 0;
+        for (const MeshData &mesh : data.meshes)
+        {
+            const unsigned char *bytes = reinterpret_cast<const unsigned char *>(mesh.vertices);
+            for (size_t i = 0; i < mesh.vertexCount * sizeof(Vertex); i += 64)
+                sum += bytes[i];
+            for (uint32_t i = 0; i < mesh.indexCount; i++)
+                sum += mesh.indices[i];
+        }
+        return sum;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; i++)
+        paths.push_back(argv[i]);
+    if (paths.empty())
+        paths = {"assets/world.glb", "assets/running_guy.gltf", "assets/dancer.gltf", "assets/hand2.glb"};
+
+    std::cout << "average of " << RUNS << " loads (ms), file cache warm after the first" << std::endl;
+    std::cout << std::left << std::setw(28) << "model" << std::setw(12) << "assimp" << std::setw(12) << "fmesh" << "speedup" << std::endl;
+
+    for (const std::string &path : paths)
+    {
+        ModelData cooked;
+        ModelImporter importer;
+        if (!importer.import(path, cooked) || !FMesh::write(FMesh::cookedPath(path), path, cooked))
+        {
+            std::cerr << "[Bench] Could not cook " << path << std::endl;
+            continue;
+        }
+
+        unsigned long long importSum = 0, mappedSum = 0;
+
+        auto start = Clock::now();
+        for (int run = 0; run < RUNS; run++)
+        {
+            ModelData data;
+            ModelImporter runImporter;
+            runImporter.import(path, data);
+            importSum += touch(data);
+        }
+        double importMs = elapsedMs(start) / RUNS;
+
+        start = Clock::now();
+        for (int run = 0; run < RUNS; run++)
+        {
+            ModelData data;
+            if (!FMesh::read(FMesh::cookedPath(path), path, data))
+            {
+                std::cerr << "[Bench] Could not read back " << FMesh::cookedPath(path) << std::endl;
+                return 1;
+            }
+            mappedSum += touch(data);
+        }
+        double mappedMs = elapsedMs(start) / RUNS;
+
+        if (importSum != mappedSum)
+        {
+            std::cerr << "[Bench] Cooked data of " << path << " differs from the import." << std::endl;
+            return 1;
+        }
+
+        std::cout << std::left << std::fixed << std::setprecision(3)
+                  << std::setw(28) << path
+                  << std::setw(12) << importMs
+                  << std::setw(12) << mappedMs
+                  << std::setprecision(1) << importMs / mappedMs << "x" << std::endl;
+    }
+    return 0;
+}
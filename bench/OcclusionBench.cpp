@@ -0,0 +1,128 @@
+// OcclusionBuffer on known scenes: a wall that must hide everything straight
+// behind it and nothing beside or in front of it, then a corridor of box
+// occluders for timing the rasterizer (single thread vs JobSystem bands) and
+// the box test.
+//
+// usage: bench_occlusion [occluderCount] [testBoxes]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "OcclusionBuffer.h"
+#include "JobSystem.h"
+
+namespace
+{
+    constexpr int RUNS = 50;
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    double elapsedMs(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // unit cube, 12 triangles
+    const glm::vec3 CUBE_POSITIONS[8] = {
+        {-0.5f, -0.5f, -0.5f}, {0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, -0.5f}, {-0.5f, 0.5f, -0.5f},
+        {-0.5f, -0.5f, 0.5f}, {0.5f, -0.5f, 0.5f}, {0.5f, 0.5f, 0.5f}, {-0.5f, 0.5f, 0.5f}};
+    const uint32_t CUBE_INDICES[36] = {
+        0, 1, 2, 2, 3, 0, 4, 5, 6, 6, 7, 4, 4, 5, 1, 1, 0, 4,
+        6, 7, 3, 3, 2, 6, 4, 7, 3, 3, 0, 4, 1, 5, 6, 6, 2, 1};
+
+    AABB boxAt(const glm::vec3 &center, const glm::vec3 &halfSize)
+    {
+        return {center - halfSize, center + halfSize};
+    }
+
+    glm::mat4 cubeMatrix(const glm::vec3 &center, const glm::vec3 &size)
+    {
+        return glm::scale(glm::translate(glm::mat4(1.0f), center), size);
+    }
+
+    bool expect(bool condition, const char *what)
+    {
+        if (!condition)
+            std::cerr << "[Bench] Unexpected result: " << what << std::endl;
+        return condition;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int occluderCount = argc > 1 ? std::atoi(argv[1]) : 200;
+    int testCount = argc > 2 ? std::atoi(argv[2]) : 100000;
+
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 2.0f, 0.1f, 500.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 viewProjection = projection * view;
+
+    JobSystem jobs;
+    OcclusionBuffer buffer;
+
+    // known scene: a 40 x 20 wall 20 units ahead, its shadow reaches x = +-41 at 40 units
+    buffer.Begin(viewProjection);
+    buffer.AddOccluder(CUBE_POSITIONS, CUBE_INDICES, 36, cubeMatrix(glm::vec3(0.0f, 0.0f, -20.0f), glm::vec3(40.0f, 20.0f, 1.0f)));
+    buffer.Rasterize(&jobs);
+
+    bool ok = true;
+    ok &= expect(!buffer.isVisible(boxAt(glm::vec3(0.0f, 0.0f, -40.0f), glm::vec3(2.0f))), "box behind the wall visible");
+    ok &= expect(!buffer.isVisible(boxAt(glm::vec3(5.0f, 3.0f, -80.0f), glm::vec3(5.0f))), "large box far behind the wall visible");
+    ok &= expect(buffer.isVisible(boxAt(glm::vec3(0.0f, 0.0f, -10.0f), glm::vec3(2.0f))), "box in front of the wall hidden");
+    ok &= expect(buffer.isVisible(boxAt(glm::vec3(120.0f, 0.0f, -100.0f), glm::vec3(2.0f))), "box beside the wall hidden");
+    ok &= expect(buffer.isVisible(boxAt(glm::vec3(0.0f, 0.0f, -20.0f), glm::vec3(30.0f, 15.0f, 5.0f))), "box intersecting the wall hidden");
+    ok &= expect(buffer.isVisible(boxAt(glm::vec3(41.0f, 0.0f, -40.0f), glm::vec3(3.0f))), "box peeking past the wall edge hidden");
+
+    // corridor: random box occluders along both sides and across, test boxes scattered behind them
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    std::vector<glm::mat4> occluders(occluderCount);
+    for (glm::mat4 &matrix : occluders)
+    {
+        glm::vec3 center((unit(rng) - 0.5f) * 80.0f, (unit(rng) - 0.5f) * 10.0f, -10.0f - unit(rng) * 60.0f);
+        glm::vec3 size(2.0f + unit(rng) * 10.0f, 2.0f + unit(rng) * 8.0f, 0.5f + unit(rng) * 2.0f);
+        matrix = cubeMatrix(center, size);
+    }
+
+    std::vector<AABB> tests(testCount);
+    for (AABB &box : tests)
+        box = boxAt(glm::vec3((unit(rng) - 0.5f) * 200.0f, (unit(rng) - 0.5f) * 40.0f, -20.0f - unit(rng) * 200.0f), glm::vec3(0.5f + unit(rng) * 2.0f));
+
+    auto rasterize = [&](JobSystem *pool)
+    {
+        auto start = Clock::now();
+        for (int run = 0; run < RUNS; run++)
+        {
+            buffer.Begin(viewProjection);
+            for (const glm::mat4 &matrix : occluders)
+                buffer.AddOccluder(CUBE_POSITIONS, CUBE_INDICES, 36, matrix);
+            buffer.Rasterize(pool);
+        }
+        return elapsedMs(start) / RUNS;
+    };
+
+    double singleMs = rasterize(nullptr);
+    double pooledMs = rasterize(&jobs);
+
+    auto start = Clock::now();
+    size_t hidden = 0;
+    for (const AABB &box : tests)
+        hidden += !buffer.isVisible(box);
+    double testMs = elapsedMs(start);
+
+    std::cout << std::fixed << std::setprecision(3)
+              << occluderCount << " occluders (" << buffer.getTriangleCount() << " triangles) at "
+              << OcclusionBuffer::WIDTH << "x" << OcclusionBuffer::HEIGHT << std::endl
+              << "rasterize + pyramid: " << singleMs << " ms single thread, " << pooledMs << " ms on "
+              << jobs.getWorkerCount() << " workers + caller" << std::endl
+              << testCount << " box tests: " << testMs << " ms, " << hidden << " hidden" << std::endl;
+
+    return ok ? 0 : 1;
+}
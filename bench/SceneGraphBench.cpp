@@ -0,0 +1,167 @@
+// Scene graph load / traverse / clear cost: the old heap-allocated nodes with a
+// std::vector of children versus NodePool nodes with intrusive sibling links.
+//
+// usage: bench_scene_graph [nodeCount]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+
+#include "NodePool.h"
+
+namespace
+{
+    // what SceneManager used before the pool
+    struct LegacyNode
+    {
+        unsigned int ID;
+        std::string name;
+        NodeType type;
+        LegacyNode *parent = nullptr;
+        std::vector<LegacyNode *> children;
+    };
+
+    constexpr int RELOADS = 10;
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    double elapsedMs(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    struct Timings
+    {
+        double loadMs = 0.0, traverseMs = 0.0, clearMs = 0.0;
+        unsigned long long checksum = 0;
+    };
+
+    // parent of node i (i >= 1), same shape for both variants: a wide root with local clusters
+    std::vector<unsigned int> makeParents(int count)
+    {
+        std::mt19937 rng(42);
+        std::vector<unsigned int> parents(count, 0);
+        for (int i = 1; i < count; i++)
+        {
+            if (rng() % 4 == 0)
+                continue;
+            unsigned int window = std::min(i - 1, 64);
+            parents[i] = window == 0 ? 0 : i - 1 - rng() % window;
+        }
+        return parents;
+    }
+
+    unsigned long long visitLegacy(LegacyNode *node)
+    {
+        unsigned long long sum = node->ID + node->name.size();
+        for (LegacyNode *child : node->children)
+            sum += visitLegacy(child);
+        return sum;
+    }
+
+    unsigned long long visitPooled(Node *node)
+    {
+        unsigned long long sum = node->ID + node->name.size();
+        for (Node *child = node->firstChild; child; child = child->nextSibling)
+            sum += visitPooled(child);
+        return sum;
+    }
+
+    Timings benchLegacy(const std::vector<unsigned int> &parents)
+    {
+        Timings t;
+        std::vector<LegacyNode *> nodes;
+
+        for (int reload = 0; reload < RELOADS; reload++)
+        {
+            auto start = Clock::now();
+            nodes.push_back(new LegacyNode({0, "Root", NodeType::Root, nullptr, {}}));
+            for (size_t i = 1; i < parents.size(); i++)
+            {
+                LegacyNode *parent = nodes[parents[i]];
+                LegacyNode *node = new LegacyNode({static_cast<unsigned int>(i), "NewNode", NodeType::Empty, parent, {}});
+                nodes.push_back(node);
+                parent->children.push_back(node);
+            }
+            t.loadMs += elapsedMs(start);
+
+            start = Clock::now();
+            t.checksum += visitLegacy(nodes[0]);
+            t.traverseMs += elapsedMs(start);
+
+            start = Clock::now();
+            for (LegacyNode *node : nodes)
+                delete node;
+            nodes.clear();
+            t.clearMs += elapsedMs(start);
+        }
+        return t;
+    }
+
+    Timings benchPooled(const std::vector<unsigned int> &parents)
+    {
+        Timings t;
+        NodePool pool;
+        std::vector<Node *> nodes;
+
+        for (int reload = 0; reload < RELOADS; reload++)
+        {
+            auto start = Clock::now();
+            nodes.push_back(pool.create(0, "Root", NodeType::Root));
+            for (size_t i = 1; i < parents.size(); i++)
+            {
+                Node *node = pool.create(static_cast<unsigned int>(i), "NewNode", NodeType::Empty);
+                nodes[parents[i]]->appendChild(node);
+                nodes.push_back(node);
+            }
+            t.loadMs += elapsedMs(start);
+
+            start = Clock::now();
+            t.checksum += visitPooled(nodes[0]);
+            t.traverseMs += elapsedMs(start);
+
+            start = Clock::now();
+            pool.reset();
+            nodes.clear();
+            t.clearMs += elapsedMs(start);
+        }
+        return t;
+    }
+
+    void print(const char *label, const Timings &t)
+    {
+        std::cout << std::left << std::fixed << std::setprecision(3)
+                  << std::setw(12) << label
+                  << std::setw(14) << t.loadMs / RELOADS
+                  << std::setw(14) << t.traverseMs / RELOADS
+                  << std::setw(14) << t.clearMs / RELOADS << std::endl;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? std::atoi(argv[1]) : 50000;
+    if (count < 1)
+        count = 1;
+
+    std::vector<unsigned int> parents = makeParents(count);
+
+    Timings legacy = benchLegacy(parents);
+    Timings pooled = benchPooled(parents);
+
+    if (legacy.checksum != pooled.checksum)
+    {
+        std::cerr << "[Bench] Traversal mismatch between variants." << std::endl;
+        return 1;
+    }
+
+    std::cout << count << " nodes, average of " << RELOADS << " reloads (ms)" << std::endl;
+    std::cout << std::left << std::setw(12) << "" << std::setw(14) << "load" << std::setw(14) << "traverse" << std::setw(14) << "clear" << std::endl;
+    print("new/vector", legacy);
+    print("NodePool", pooled);
+    return 0;
+}
@@ -0,0 +1,141 @@
+// Compares component lookup/delete cost of the old SceneManager storage
+// (std::vector + linear find by ID + erase) with the SlotMap + ID table.
+//
+// usage: bench_scene_lookup
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+#include "SlotMap.h"
+
+namespace
+{
+    // roughly the footprint of a Model, so the linear scans touch as much memory as the real thing
+    struct Component
+    {
+        unsigned int ID;
+        char payload[252];
+    };
+
+    constexpr int LOOKUPS = 10000;
+    constexpr int DELETES = 1000;
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    double elapsedMs(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    struct Result
+    {
+        double lookupMs, deleteMs;
+        unsigned long long checksum;
+    };
+
+    Result benchVector(int count, const std::vector<unsigned int> &lookupIDs, const std::vector<unsigned int> &deleteIDs)
+    {
+        std::vector<Component> components;
+        for (int i = 0; i < count; i++)
+            components.push_back({static_cast<unsigned int>(i + 1), {}});
+
+        Result r = {};
+
+        auto start = Clock::now();
+        for (unsigned int id : lookupIDs)
+        {
+            for (Component &c : components)
+                if (c.ID == id)
+                {
+                    r.checksum += c.ID;
+                    break;
+                }
+        }
+        r.lookupMs = elapsedMs(start);
+
+        start = Clock::now();
+        for (unsigned int id : deleteIDs)
+        {
+            auto it = std::find_if(components.begin(), components.end(), [&](const Component &c)
+                                   { return c.ID == id; });
+            if (it != components.end())
+                components.erase(it);
+        }
+        r.deleteMs = elapsedMs(start);
+        r.checksum += components.size();
+        return r;
+    }
+
+    Result benchSlotMap(int count, const std::vector<unsigned int> &lookupIDs, const std::vector<unsigned int> &deleteIDs)
+    {
+        SlotMap<Component> components;
+        std::vector<SlotHandle> handleByID(count + 1);
+        for (int i = 0; i < count; i++)
+            handleByID[i + 1] = components.insert({static_cast<unsigned int>(i + 1), {}});
+
+        Result r = {};
+
+        auto start = Clock::now();
+        for (unsigned int id : lookupIDs)
+        {
+            if (Component *c = components.get(handleByID[id]))
+                r.checksum += c->ID;
+        }
+        r.lookupMs = elapsedMs(start);
+
+        start = Clock::now();
+        for (unsigned int id : deleteIDs)
+            components.erase(handleByID[id]);
+        r.deleteMs = elapsedMs(start);
+        r.checksum += components.size();
+        return r;
+    }
+}
+
+int main()
+{
+    std::mt19937 rng(1234);
+
+    std::cout << std::left << std::setw(10) << "nodes"
+              << std::setw(18) << "vector lookup"
+              << std::setw(18) << "slotmap lookup"
+              << std::setw(18) << "vector delete"
+              << std::setw(18) << "slotmap delete" << std::endl;
+
+    for (int count : {1000, 10000, 100000})
+    {
+        std::uniform_int_distribution<unsigned int> pick(1, count);
+        std::vector<unsigned int> lookupIDs(LOOKUPS);
+        for (unsigned int &id : lookupIDs)
+            id = pick(rng);
+
+        std::vector<unsigned int> deleteIDs(count);
+        for (int i = 0; i < count; i++)
+            deleteIDs[i] = i + 1;
+        std::shuffle(deleteIDs.begin(), deleteIDs.end(), rng);
+        deleteIDs.resize(DELETES);
+
+        Result vec = benchVector(count, lookupIDs, deleteIDs);
+        Result slot = benchSlotMap(count, lookupIDs, deleteIDs);
+
+        if (vec.checksum != slot.checksum)
+        {
+            std::cerr << "[Bench] Checksum mismatch at " << count << " nodes." << std::endl;
+            return 1;
+        }
+
+        std::cout << std::left << std::fixed << std::setprecision(3)
+                  << std::setw(10) << count
+                  << std::setw(18) << vec.lookupMs
+                  << std::setw(18) << slot.lookupMs
+                  << std::setw(18) << vec.deleteMs
+                  << std::setw(18) << slot.deleteMs << std::endl;
+    }
+
+    std::cout << "(times in ms for " << LOOKUPS << " random lookups and " << DELETES << " random deletes)" << std::endl;
+    return 0;
+}
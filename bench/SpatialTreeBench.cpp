@@ -0,0 +1,176 @@
+// AABBTree under a scene-sized load: build, per-frame refit with a small share
+// of the objects moving, and batched box / sphere / frustum / ray queries
+// compared against a linear scan over the same boxes.
+//
+// usage: bench_spatial_tree [objectCount] [movingPercent]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "AABBTree.h"
+
+namespace
+{
+    constexpr int FRAMES = 300;
+    constexpr int QUERIES = 1000;
+    constexpr float WORLD = 1000.0f;
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    double elapsedMs(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    struct Object
+    {
+        glm::vec3 position;
+        glm::vec3 halfSize;
+        glm::vec3 velocity;
+        uint32_t proxy;
+
+        AABB box() const { return {position - halfSize, position + halfSize}; }
+    };
+
+    size_t linearCount(const std::vector<Object> &objects, const AABB &query)
+    {
+        size_t hits = 0;
+        for (const Object &object : objects)
+            hits += TreeMath::overlaps(object.box(), query);
+        return hits;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int count = argc > 1 ? std::atoi(argv[1]) : 100000;
+    float movingPercent = argc > 2 ? static_cast<float>(std::atof(argv[2])) : 1.0f;
+    count = std::max(count, 1);
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> coord(-WORLD, WORLD);
+    std::uniform_real_distribution<float> size(0.25f, 2.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    std::vector<Object> objects(count);
+    for (Object &object : objects)
+    {
+        object.position = glm::vec3(coord(rng), coord(rng) * 0.1f, coord(rng));
+        object.halfSize = glm::vec3(size(rng), size(rng), size(rng));
+        object.velocity = glm::vec3(unit(rng), unit(rng) * 0.2f, unit(rng)) * 0.5f;
+    }
+
+    // build
+    AABBTree tree(0.5f);
+    auto start = Clock::now();
+    for (size_t i = 0; i < objects.size(); i++)
+        objects[i].proxy = tree.insert(objects[i].box(), static_cast<uint32_t>(i));
+    double buildMs = elapsedMs(start);
+
+    std::cout << count << " objects, built in " << std::fixed << std::setprecision(2) << buildMs << " ms"
+              << ", height " << tree.getHeight() << ", area ratio " << tree.getAreaRatio() << std::endl;
+
+    // refit, the same random subset moves every frame like a crowd of active bodies
+    size_t movingCount = std::max<size_t>(1, static_cast<size_t>(count * movingPercent / 100.0f));
+    std::vector<uint32_t> moving(count);
+    for (int i = 0; i < count; i++)
+        moving[i] = i;
+    std::shuffle(moving.begin(), moving.end(), rng);
+    moving.resize(movingCount);
+
+    double totalMs = 0.0, worstMs = 0.0;
+    size_t reinserted = 0;
+    for (int frame = 0; frame < FRAMES; frame++)
+    {
+        for (uint32_t index : moving)
+            objects[index].position += objects[index].velocity;
+
+        start = Clock::now();
+        for (uint32_t index : moving)
+            reinserted += tree.move(objects[index].proxy, objects[index].box(), objects[index].velocity);
+        double ms = elapsedMs(start);
+        totalMs += ms;
+        worstMs = std::max(worstMs, ms);
+    }
+
+    std::cout << std::setprecision(3)
+              << movingCount << " moving per frame: " << totalMs / FRAMES << " ms average, " << worstMs << " ms worst, "
+              << static_cast<double>(reinserted) / FRAMES << " reinserts per frame" << std::endl;
+    std::cout << "after " << FRAMES << " frames: height " << tree.getHeight() << ", area ratio " << std::setprecision(2) << tree.getAreaRatio() << std::endl;
+
+    // queries
+    std::vector<AABB> boxes(QUERIES);
+    std::vector<BoundingSphere> spheres(QUERIES);
+    std::vector<TreeRay> rays(QUERIES);
+    for (int i = 0; i < QUERIES; i++)
+    {
+        glm::vec3 center(coord(rng), coord(rng) * 0.1f, coord(rng));
+        boxes[i] = {center - glm::vec3(10.0f), center + glm::vec3(10.0f)};
+        spheres[i].center = center;
+        spheres[i].radius = 10.0f;
+        rays[i].origin = center;
+        rays[i].direction = glm::normalize(glm::vec3(unit(rng), unit(rng) * 0.1f, unit(rng)));
+        rays[i].maxDistance = 500.0f;
+    }
+
+    TreeQueryResults results;
+    std::vector<TreeRayHit> hits;
+
+    start = Clock::now();
+    tree.query(boxes.data(), boxes.size(), results);
+    double boxMs = elapsedMs(start);
+    size_t boxHits = results.items.size();
+
+    start = Clock::now();
+    size_t linearHits = 0;
+    for (const AABB &box : boxes)
+        linearHits += linearCount(objects, box);
+    double linearMs = elapsedMs(start);
+
+    start = Clock::now();
+    tree.query(spheres.data(), spheres.size(), results);
+    double sphereMs = elapsedMs(start);
+    size_t sphereHits = results.items.size();
+
+    start = Clock::now();
+    tree.raycast(rays.data(), rays.size(), hits);
+    double rayMs = elapsedMs(start);
+    size_t rayHits = std::count_if(hits.begin(), hits.end(), [](const TreeRayHit &hit)
+                                   { return hit.item != AABBTree::NONE; });
+
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 300.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 20.0f, 0.0f), glm::vec3(0.0f, 0.0f, -100.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    Frustum frustum(projection * view);
+
+    start = Clock::now();
+    tree.query(&frustum, 1, results);
+    double frustumMs = elapsedMs(start);
+    size_t frustumHits = results.items.size();
+
+    start = Clock::now();
+    size_t linearFrustumHits = 0;
+    for (const Object &object : objects)
+        linearFrustumHits += frustum.testAABB(object.box());
+    double linearFrustumMs = elapsedMs(start);
+
+    std::cout << std::setprecision(3)
+              << QUERIES << " box queries:    " << boxMs << " ms (" << boxHits << " hits), linear " << linearMs << " ms (" << linearHits << " hits)" << std::endl
+              << QUERIES << " sphere queries: " << sphereMs << " ms (" << sphereHits << " hits)" << std::endl
+              << QUERIES << " rays:           " << rayMs << " ms (" << rayHits << " hit)" << std::endl
+              << "frustum query:       " << frustumMs << " ms (" << frustumHits << " hits), linear " << linearFrustumMs << " ms (" << linearFrustumHits << " hits)" << std::endl;
+
+    // fat boxes only ever add hits
+    if (boxHits < linearHits || frustumHits < linearFrustumHits)
+    {
+        std::cerr << "[Bench] Tree missed objects the linear scan found." << std::endl;
+        return 1;
+    }
+    return 0;
+}
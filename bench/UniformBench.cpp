@@ -0,0 +1,206 @@
+// Per-frame CPU cost of the model shader's uniforms for a crowd of animated
+// characters: the old name based path (string building plus a driver location
+// lookup per uniform, one upload per bone) against locations reflected once
+// into a UniformCache and whole-array uploads.
+//
+// There is no GL context here, so the driver side is stood in for by a sorted
+// name table (glGetUniformLocation) and a memcpy into a staging buffer (glUniform*).
+//
+// usage: bench_uniforms [characters] [bones] [lights]
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <map>
+#include <chrono>
+#include <cstring>
+#include <cstdlib>
+
+#include <glm/glm.hpp>
+
+#include "UniformCache.h"
+
+namespace
+{
+    constexpr int FRAMES = 200;
+    constexpr int BONE_ARRAY = 200;
+    constexpr int LIGHT_ARRAY = 16;
+
+    using Clock = std::chrono::high_resolution_clock;
+
+    // what the driver does for us: look names up, copy values
+    class FakeDriver
+    {
+    public:
+        unsigned long long lookups = 0, uploads = 0;
+
+        FakeDriver()
+        {
+            int location = 0;
+            auto addArray = [&](const std::string &name, int size)
+            {
+                for (int i = 0; i < size; i++)
+                    names[name + "[" + std::to_string(i) + "]"] = location++;
+                names[name] = names[name + "[0]"];
+            };
+            for (const char *name : {"projection", "view", "model", "normalMatrix", "isAnimated", "uCamPos", "numLights", "texture_diffuse0", "texture_specular0"})
+                names[name] = location++;
+            addArray("bone_transforms", BONE_ARRAY);
+            addArray("lightPositions", LIGHT_ARRAY);
+            addArray("lightColors", LIGHT_ARRAY);
+            staging.resize(location * 64);
+        }
+
+        int getUniformLocation(const char *name)
+        {
+            lookups++;
+            auto it = names.find(name);
+            return it != names.end() ? it->second : -1;
+        }
+
+        void upload(int location, const void *data, size_t size, int count = 1)
+        {
+            uploads++;
+            // one 64 byte slot per location, arrays take consecutive ones
+            const unsigned char *src = static_cast<const unsigned char *>(data);
+            for (int i = 0; location >= 0 && i < count; i++)
+                std::memcpy(&staging[(location + i) * 64], src + i * size, size);
+        }
+
+        // reflection: what Shader::reflectUniforms stores
+        void fill(UniformCache &cache) const
+        {
+            for (auto &[name, location] : names)
+                cache.add(name, {location, 0, 1});
+        }
+
+        const std::vector<unsigned char> &getStaging() const { return staging; }
+
+    private:
+        std::map<std::string, int> names;
+        std::vector<unsigned char> staging;
+    };
+
+    struct Scene
+    {
+        std::vector<std::vector<glm::mat4>> palettes; // per character
+        std::vector<glm::mat4> models;
+        std::vector<glm::mat3> normals;
+        std::vector<glm::vec3> lightPositions, lightColors;
+    };
+
+    // SceneManager::RenderModels + Model::Draw + Mesh::Draw before reflection
+    void frameByName(FakeDriver &gl, const Scene &scene)
+    {
+        int lightCount = static_cast<int>(scene.lightPositions.size());
+        gl.upload(gl.getUniformLocation("numLights"), &lightCount, sizeof(int));
+        for (int i = 0; i < lightCount; ++i)
+        {
+            std::string posName = "lightPositions[" + std::to_string(i) + "]";
+            std::string colName = "lightColors[" + std::to_string(i) + "]";
+            gl.upload(gl.getUniformLocation(posName.c_str()), &scene.lightPositions[i], sizeof(glm::vec3));
+            gl.upload(gl.getUniformLocation(colName.c_str()), &scene.lightColors[i], sizeof(glm::vec3));
+        }
+
+        for (size_t c = 0; c < scene.models.size(); c++)
+        {
+            gl.upload(gl.getUniformLocation("model"), &scene.models[c], sizeof(glm::mat4));
+            gl.upload(gl.getUniformLocation("normalMatrix"), &scene.normals[c], sizeof(glm::mat3));
+
+            int animated = 1;
+            gl.upload(gl.getUniformLocation("isAnimated"), &animated, sizeof(int));
+            const std::vector<glm::mat4> &palette = scene.palettes[c];
+            for (size_t i = 0; i < palette.size(); i++)
+            {
+                std::string uniformName = "bone_transforms[" + std::to_string(i) + "]";
+                gl.upload(gl.getUniformLocation(uniformName.c_str()), &palette[i], sizeof(glm::mat4));
+            }
+
+            int unit = 0;
+            std::string sampler = std::string("texture_diffuse") + std::to_string(0);
+            gl.upload(gl.getUniformLocation(sampler.c_str()), &unit, sizeof(int));
+        }
+    }
+
+    // the same frame with reflected locations
+    void frameCached(FakeDriver &gl, const UniformCache &cache, const Scene &scene, const std::string &sampler)
+    {
+        const int modelLoc = cache.getLocation("model");
+        const int normalMatrixLoc = cache.getLocation("normalMatrix");
+
+        int lightCount = static_cast<int>(scene.lightPositions.size());
+        gl.upload(cache.getLocation("numLights"), &lightCount, sizeof(int));
+        gl.upload(cache.getLocation("lightPositions"), scene.lightPositions.data(), sizeof(glm::vec3), lightCount);
+        gl.upload(cache.getLocation("lightColors"), scene.lightColors.data(), sizeof(glm::vec3), lightCount);
+
+        for (size_t c = 0; c < scene.models.size(); c++)
+        {
+            gl.upload(modelLoc, &scene.models[c], sizeof(glm::mat4));
+            gl.upload(normalMatrixLoc, &scene.normals[c], sizeof(glm::mat3));
+
+            int animated = 1;
+            gl.upload(cache.getLocation("isAnimated"), &animated, sizeof(int));
+            const std::vector<glm::mat4> &palette = scene.palettes[c];
+            gl.upload(cache.getLocation("bone_transforms"), palette.data(), sizeof(glm::mat4), static_cast<int>(palette.size()));
+
+            int unit = 0;
+            gl.upload(cache.getLocation(sampler), &unit, sizeof(int));
+        }
+    }
+
+    void print(const char *label, double ms, const FakeDriver &gl)
+    {
+        std::cout << std::left << std::fixed << std::setprecision(4)
+                  << std::setw(12) << label
+                  << std::setw(14) << ms / FRAMES
+                  << std::setw(14) << gl.lookups / FRAMES
+                  << std::setw(14) << gl.uploads / FRAMES << std::endl;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int characters = argc > 1 ? std::atoi(argv[1]) : 50;
+    int bones = argc > 2 ? std::atoi(argv[2]) : 65;
+    int lights = argc > 3 ? std::atoi(argv[3]) : 8;
+    bones = std::max(1, std::min(bones, BONE_ARRAY));
+    lights = std::max(0, std::min(lights, LIGHT_ARRAY));
+
+    Scene scene;
+    for (int c = 0; c < characters; c++)
+    {
+        scene.palettes.emplace_back(bones, glm::mat4(1.0f + c));
+        scene.models.push_back(glm::mat4(float(c)));
+        scene.normals.push_back(glm::mat3(float(c)));
+    }
+    scene.lightPositions.assign(lights, glm::vec3(1.0f));
+    scene.lightColors.assign(lights, glm::vec3(0.5f));
+
+    FakeDriver byName, cached;
+    UniformCache cache;
+    cached.fill(cache);
+    const std::string sampler = "texture_diffuse0"; // Mesh::samplerNames
+
+    auto start = Clock::now();
+    for (int frame = 0; frame < FRAMES; frame++)
+        frameByName(byName, scene);
+    double byNameMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    for (int frame = 0; frame < FRAMES; frame++)
+        frameCached(cached, cache, scene, sampler);
+    double cachedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    if (byName.getStaging() != cached.getStaging())
+    {
+        std::cerr << "[Bench] Uploaded uniform values differ between paths." << std::endl;
+        return 1;
+    }
+
+    std::cout << characters << " characters, " << bones << " bones, " << lights << " lights, per frame" << std::endl;
+    std::cout << std::left << std::setw(12) << "" << std::setw(14) << "cpu ms" << std::setw(14) << "lookups" << std::setw(14) << "uploads" << std::endl;
+    print("by name", byNameMs, byName);
+    print("reflected", cachedMs, cached);
+    return 0;
+}
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+#include "Bounds.h"
+
+struct TreeRay
+{
+    glm::vec3 origin = glm::vec3(0.0f);
+    glm::vec3 direction = glm::vec3(0.0f, 0.0f, -1.0f);
+    float maxDistance = 1e30f;
+};
+
+struct TreeRayHit
+{
+    uint32_t item = 0xFFFFFFFF; // NONE when nothing was hit
+    float distance = 0.0f;
+};
+
+// results of a batched query, the hits of query i are items[offsets[i] .. offsets[i + 1])
+struct TreeQueryResults
+{
+    std::vector<uint32_t> items;
+    std::vector<uint32_t> offsets;
+
+    size_t queryCount() const { return offsets.empty() ? 0 : offsets.size() - 1; }
+    size_t count(size_t query) const { return offsets[query + 1] - offsets[query]; }
+    const uint32_t *begin(size_t query) const { return items.data() + offsets[query]; }
+    const uint32_t *end(size_t query) const { return items.data() + offsets[query + 1]; }
+};
+
+// Dynamic bounding volume hierarchy over loose ("fat") boxes.
+// Leaves are inserted next to the sibling that grows the total surface area the
+// least (branch and bound over the whole tree), and every ancestor touched on the
+// way back up is rotated when swapping a grandchild makes it smaller. A moved
+// object only leaves and re-enters the tree once it escapes its fat box, so small
+// per-frame motion costs one containment test.
+class AABBTree
+{
+public:
+    static constexpr uint32_t NONE = 0xFFFFFFFF;
+    static constexpr float DISPLACEMENT_MULTIPLIER = 4.0f;
+
+    // fat boxes are grown by this much on every side
+    explicit AABBTree(float margin = 0.1f);
+
+    // returns the proxy handle, item is handed back by the queries
+    uint32_t insert(const AABB &box, uint32_t item);
+    void remove(uint32_t proxy);
+    // true if the proxy had to be reinserted. displacement is the motion since the
+    // last move, when known it stretches the fat box ahead of the object
+    bool move(uint32_t proxy, const AABB &box, const glm::vec3 &displacement = glm::vec3(0.0f));
+    void clear();
+
+    uint32_t getItem(uint32_t proxy) const { return nodes[proxy].item; }
+    const AABB &getFatBox(uint32_t proxy) const { return nodes[proxy].box; }
+
+    size_t size() const { return leafCount; }
+    int getHeight() const { return root == NONE ? 0 : nodes[root].height; }
+    // summed surface area of the internal nodes over the root's, lower is better
+    float getAreaRatio() const;
+
+    // visitor(item) returns false to stop early
+    template <typename Visitor>
+    void query(const AABB &box, Visitor &&visitor) const;
+    template <typename Visitor>
+    void query(const BoundingSphere &sphere, Visitor &&visitor) const;
+    template <typename Visitor>
+    void query(const Frustum &frustum, Visitor &&visitor) const;
+    // visitor(item, distance to the fat box) returns the new max distance: 0 stops,
+    // the distance clips the ray to the closest hit, ray.maxDistance keeps going
+    template <typename Visitor>
+    void raycast(const TreeRay &ray, Visitor &&visitor) const;
+
+    // many queries at once, sharing one traversal stack
+    void query(const AABB *boxes, size_t count, TreeQueryResults &results) const;
+    void query(const BoundingSphere *spheres, size_t count, TreeQueryResults &results) const;
+    void query(const Frustum *frustums, size_t count, TreeQueryResults &results) const;
+    // closest fat box along each ray, refine with the single-ray visitor when exact hits matter
+    void raycast(const TreeRay *rays, size_t count, std::vector<TreeRayHit> &hits) const;
+
+private:
+    struct TreeNode
+    {
+        AABB box;
+        uint32_t parent = NONE;
+        uint32_t child1 = NONE;
+        uint32_t child2 = NONE; // NONE for leaves, doubles as the free list link
+        int height = 0;         // 0 for leaves, -1 while free
+        uint32_t item = NONE;
+
+        bool isLeaf() const { return child1 == NONE; }
+    };
+
+    std::vector<TreeNode> nodes;
+    uint32_t root = NONE;
+    uint32_t freeList = NONE;
+    size_t leafCount = 0;
+    float margin;
+
+    // scratch space, so queries are not safe to run from several threads on one tree
+    mutable std::vector<uint32_t> stack;
+    mutable std::vector<std::pair<uint32_t, float>> candidates; // node, growth of its ancestors
+
+    uint32_t allocateNode();
+    void freeNode(uint32_t index);
+
+    void insertLeaf(uint32_t leaf);
+    void removeLeaf(uint32_t leaf);
+    uint32_t findBestSibling(const AABB &box) const;
+    void refitFrom(uint32_t index);
+    void rotate(uint32_t index);
+
+    template <typename Overlaps, typename Visitor>
+    void traverse(Overlaps &&overlaps, Visitor &&visitor, std::vector<uint32_t> &stack) const;
+};
+
+namespace TreeMath
+{
+    // half the surface area, only ever compared
+    inline float area(const AABB &box)
+    {
+        glm::vec3 d = box.max - box.min;
+        return d.x * d.y + d.y * d.z + d.z * d.x;
+    }
+
+    inline AABB merge(const AABB &a, const AABB &b)
+    {
+        return {glm::min(a.min, b.min), glm::max(a.max, b.max)};
+    }
+
+    inline bool overlaps(const AABB &a, const AABB &b)
+    {
+        return a.min.x <= b.max.x && a.max.x >= b.min.x &&
+               a.min.y <= b.max.y && a.max.y >= b.min.y &&
+               a.min.z <= b.max.z && a.max.z >= b.min.z;
+    }
+
+    inline bool overlaps(const AABB &box, const BoundingSphere &sphere)
+    {
+        glm::vec3 closest = glm::clamp(sphere.center, box.min, box.max);
+        glm::vec3 d = closest - sphere.center;
+        return glm::dot(d, d) <= sphere.radius * sphere.radius;
+    }
+
+    // slab test, entry distance or -1 on a miss
+    inline float intersect(const AABB &box, const glm::vec3 &origin, const glm::vec3 &inverseDirection, float maxDistance)
+    {
+        glm::vec3 t1 = (box.min - origin) * inverseDirection;
+        glm::vec3 t2 = (box.max - origin) * inverseDirection;
+        glm::vec3 tMin = glm::min(t1, t2);
+        glm::vec3 tMax = glm::max(t1, t2);
+        float enter = glm::max(glm::max(tMin.x, tMin.y), glm::max(tMin.z, 0.0f));
+        float exit = glm::min(glm::min(tMax.x, tMax.y), glm::min(tMax.z, maxDistance));
+        return enter <= exit ? enter : -1.0f;
+    }
+}
+
+template <typename Overlaps, typename Visitor>
+void AABBTree::traverse(Overlaps &&overlaps, Visitor &&visitor, std::vector<uint32_t> &stack) const
+{
+    if (root == NONE)
+        return;
+
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty())
+    {
+        const TreeNode &node = nodes[stack.back()];
+        stack.pop_back();
+
+        if (!overlaps(node.box))
+            continue;
+
+        if (node.isLeaf())
+        {
+            if (!visitor(node.item))
+                return;
+        }
+        else
+        {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
+template <typename Visitor>
+void AABBTree::query(const AABB &box, Visitor &&visitor) const
+{
+    traverse([&](const AABB &nodeBox)
+             { return TreeMath::overlaps(nodeBox, box); },
+             visitor, stack);
+}
+
+template <typename Visitor>
+void AABBTree::query(const BoundingSphere &sphere, Visitor &&visitor) const
+{
+    traverse([&](const AABB &nodeBox)
+             { return TreeMath::overlaps(nodeBox, sphere); },
+             visitor, stack);
+}
+
+template <typename Visitor>
+void AABBTree::query(const Frustum &frustum, Visitor &&visitor) const
+{
+    traverse([&](const AABB &nodeBox)
+             { return frustum.testAABB(nodeBox); },
+             visitor, stack);
+}
+
+template <typename Visitor>
+void AABBTree::raycast(const TreeRay &ray, Visitor &&visitor) const
+{
+    if (root == NONE)
+        return;
+
+    const glm::vec3 inverseDirection = 1.0f / ray.direction;
+    float maxDistance = ray.maxDistance;
+
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty())
+    {
+        const TreeNode &node = nodes[stack.back()];
+        stack.pop_back();
+
+        float distance = TreeMath::intersect(node.box, ray.origin, inverseDirection, maxDistance);
+        if (distance < 0.0f)
+            continue;
+
+        if (node.isLeaf())
+        {
+            float clipped = visitor(node.item, distance);
+            if (clipped <= 0.0f)
+                return;
+            maxDistance = glm::min(maxDistance, clipped);
+        }
+        else
+        {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
@@ -5,9 +5,8 @@
 #include <unordered_map>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
-#include <assimp/scene.h>
 
-// Forward-declare structs from Model.h to avoid circular dependency
+// Forward-declare structs from ModelData.h to avoid circular dependency
 struct Bone;
 struct Skeleton;
 
@@ -30,6 +29,7 @@ struct Animation
     std::unordered_map<std::string, BoneTransformTrack> boneTransforms = {};
 };
 
+// Per-instance playback state. The clips themselves belong to the shared ModelAsset.
 class Animator
 {
 public:
@@ -41,26 +41,22 @@ public:
 
     Animator();
 
-    void loadAnimation(const aiScene *scene);
-    void updateAnimation(float deltaTime, Skeleton &skeleton, std::vector<glm::mat4> &finalBoneMatrices, const glm::mat4 &globalInverseTransform);
-    void updatePose(Skeleton &skeleton, std::vector<glm::mat4> &finalBoneMatrices, const glm::mat4 &globalInverseTransform);
+    void setAnimations(const std::vector<Animation> *clips);
+    void updateAnimation(float deltaTime, const Skeleton &skeleton, std::vector<glm::mat4> &finalBoneMatrices, const glm::mat4 &globalInverseTransform);
+    void updatePose(const Skeleton &skeleton, std::vector<glm::mat4> &finalBoneMatrices, const glm::mat4 &globalInverseTransform);
 
     // --- Playback Controls ---
     void play();
     void pause();
     void setAnimation(int index);
-    void seek(float time, Skeleton &skeleton, std::vector<glm::mat4> &finalBoneMatrices, const glm::mat4 &globalInverseTransform);
+    void seek(float time, const Skeleton &skeleton, std::vector<glm::mat4> &finalBoneMatrices, const glm::mat4 &globalInverseTransform);
 
     // --- Data Access ---
-    Animation *getCurrentAnimation();
+    const Animation *getCurrentAnimation();
 
 private:
-    std::vector<Animation> animations;
+    const std::vector<Animation> *animations = nullptr;
 
-    void getPose(Animation &animation, Bone &skeletonBone, float dt, std::vector<glm::mat4> &output, const glm::mat4 &parentTransform, const glm::mat4 &globalInverseTransform);
-    std::pair<unsigned int, float> getTimeFraction(std::vector<float> &times, float &dt);
-
-    // Helper converters
-    glm::vec3 assimpToGlmVec3(const aiVector3D &vec);
-    glm::quat assimpToGlmQuat(const aiQuaternion &quat);
+    void getPose(const Animation &animation, const Bone &skeletonBone, float dt, std::vector<glm::mat4> &output, const glm::mat4 &parentTransform, const glm::mat4 &globalInverseTransform);
+    std::pair<unsigned int, float> getTimeFraction(const std::vector<float> &times, float &dt);
 };
\ No newline at end of file
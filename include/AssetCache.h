@@ -0,0 +1,98 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+
+#include "ModelAsset.h"
+#include "Texture.h"
+#include "JobSystem.h"
+#include "GeometryArena.h"
+
+// Path keyed cache of models and their textures.
+// loadModel() returns at once with an asset in the Loading state; the file is
+// read and its textures decoded on the JobSystem, and processUploads() turns the
+// finished CPU data into GL objects with the context current, a little every frame.
+// The cache holds one reference to every asset, so an asset stays resident while
+// any Model instance uses it and is freed by releaseUnused() once none do.
+class AssetCache
+{
+public:
+    // GL upload time processUploads() may spend per frame
+    float uploadBudgetMs = 2.0f;
+
+    // meshes above this many triangles are not kept for occlusion, occluders should be simple
+    static constexpr uint32_t MAX_OCCLUDER_TRIANGLES = 4096;
+
+    AssetCache(JobSystem &jobs, GeometryArena &geometry);
+    ~AssetCache();
+
+    AssetCache(const AssetCache &) = delete;
+    AssetCache &operator=(const AssetCache &) = delete;
+
+    // returns the shared asset for path, queueing its import on first use
+    std::shared_ptr<ModelAsset> loadModel(const std::string &path);
+
+    // once per frame, with the GL context current
+    void processUploads();
+    // whether processUploads() has anything to do
+    bool hasPendingUploads();
+
+    // drops assets no Model references anymore, and textures no remaining asset uses
+    void releaseUnused();
+    void clear();
+
+    size_t modelCount() const { return models.size(); }
+    size_t textureCount() const { return textures.size(); }
+    unsigned int loadingCount() const { return loading; }
+
+private:
+    struct PendingImage
+    {
+        TextureImage image;
+        std::atomic<bool> ready{false};
+    };
+
+    struct PendingUpload
+    {
+        std::shared_ptr<ModelAsset> asset;
+        ModelData data;
+        std::vector<OccluderMesh> occluderMeshes;
+        bool failed = false;
+        float importMs = 0.f;
+        size_t nextMesh = 0;
+    };
+
+    JobSystem &jobs;
+    // every imported mesh is sub-allocated from here
+    GeometryArena &geometry;
+
+    std::unordered_map<std::string, std::shared_ptr<ModelAsset>> models;
+    std::unordered_map<std::string, Texture> textures;
+    std::shared_ptr<Mesh> placeholder;
+    unsigned int loading = 0;
+
+    // handed over by the workers
+    std::mutex finishedMutex;
+    std::vector<std::unique_ptr<PendingUpload>> finished;
+    // processUploads() only, partially uploaded assets
+    std::vector<std::unique_ptr<PendingUpload>> uploading;
+
+    // one decode per texture path, no matter how many models reference it
+    std::mutex imageMutex;
+    std::unordered_map<std::string, std::shared_ptr<PendingImage>> images;
+
+    void importJob(const std::shared_ptr<ModelAsset> &asset);
+    void decodeImage(const std::string &path);
+
+    // uploads the next mesh, false if one of its textures is still being decoded
+    bool uploadStep(PendingUpload &upload);
+    // keyed by path only, callers take type and unit from their own MaterialTexture
+    const Texture *resolveTexture(const MaterialTexture &texture);
+    void finishUpload(PendingUpload &upload);
+
+    const std::shared_ptr<Mesh> &getPlaceholder();
+};
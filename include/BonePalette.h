@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+
+#include "BufferObjects/StreamBuffer.h"
+
+// texture unit the palette is bound to, above anything a mesh binds
+constexpr unsigned int BONE_PALETTE_UNIT = 15;
+
+// Skinning matrices of every animated model in the frame, written straight
+// into the frame's StreamBuffer segment and read through a GL_TEXTURE_BUFFER
+// (RGBA32F, 4 texels per matrix) spanning the whole stream buffer.
+// Each draw only passes the index of its first matrix, so there is no
+// per-bone uniform traffic and no fixed bone limit in the shader.
+class BonePalette
+{
+public:
+    BonePalette() = default;
+    ~BonePalette();
+
+    BonePalette(const BonePalette &) = delete;
+    BonePalette &operator=(const BonePalette &) = delete;
+
+    // reserves room for this frame's matrices
+    bool Begin(StreamBuffer &stream, size_t matrixCount);
+    // returns the index of the first appended matrix, as the shader sees it
+    unsigned int Append(const std::vector<glm::mat4> &bones);
+    void End(StreamBuffer &stream);
+
+    void Bind(unsigned int unit = BONE_PALETTE_UNIT);
+
+    size_t size() const { return written; }
+
+private:
+    StreamAllocation allocation;
+    size_t capacity = 0, written = 0; // in matrices
+
+    unsigned int textureID = 0;
+    unsigned int attachedBuffer = 0;
+};
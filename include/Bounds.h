@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cfloat>
+
+#include <glm/glm.hpp>
+
+// Axis aligned box, starts out empty (min > max) and grows with expand().
+struct AABB
+{
+    glm::vec3 min = glm::vec3(FLT_MAX);
+    glm::vec3 max = glm::vec3(-FLT_MAX);
+
+    bool isValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+    glm::vec3 center() const { return (min + max) * 0.5f; }
+    glm::vec3 extents() const { return (max - min) * 0.5f; }
+
+    void expand(const glm::vec3 &point);
+    void expand(const AABB &other);
+
+    // box around the transformed box (Arvo), not around the transformed contents
+    AABB transformed(const glm::mat4 &matrix) const;
+};
+
+// xyz center, w radius
+struct BoundingSphere
+{
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = -1.0f; // negative = empty
+
+    bool isValid() const { return radius >= 0.0f; }
+
+    static BoundingSphere fromAABB(const AABB &box);
+    // radius scaled by the largest axis scale of the matrix
+    BoundingSphere transformed(const glm::mat4 &matrix) const;
+};
+
+// Six planes from a view-projection matrix (Gribb/Hartmann), normals pointing inwards.
+// Stored as two groups of four planes so SSE tests four planes per instruction;
+// the last two slots hold a plane everything is in front of.
+class Frustum
+{
+public:
+    Frustum();
+    explicit Frustum(const glm::mat4 &viewProjection);
+
+    bool testSphere(const BoundingSphere &sphere) const;
+    bool testAABB(const AABB &box) const;
+
+private:
+    alignas(16) float nx[8], ny[8], nz[8], d[8];
+};
@@ -8,8 +8,10 @@
 class ElementBuffer
 {
 public:
-    unsigned int ID;
+    unsigned int ID = 0;
 
+    // no GL object, for meshes whose indices live in a GeometryArena
+    ElementBuffer() = default;
     ElementBuffer(const void *data, unsigned int size);
     void AddAttribLayout(unsigned int index, int count, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer);
     void Bind();
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <iostream>
+#include <cstddef>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+// a slice of the stream buffer, valid until the end of the frame
+struct StreamAllocation
+{
+    void *data = nullptr;
+    unsigned int buffer = 0;
+    size_t offset = 0; // bytes into buffer
+    size_t size = 0;
+
+    explicit operator bool() const { return data != nullptr; }
+};
+
+// Ring of FRAMES per-frame segments in one GL buffer, for everything that is
+// rewritten every frame (instance data, bone palettes, particles, indirect
+// commands). Writers get a pointer straight into GPU visible memory.
+//
+// With buffer storage the buffer is mapped persistently and coherently once.
+// Otherwise each allocation maps its range unsynchronized and Commit() unmaps
+// it, so in that mode only one allocation may be open at a time and it must be
+// committed before the data is drawn from. Always call Commit().
+//
+// A fence is placed at the end of every frame; a segment is only reused once
+// the GPU has passed the fence of the frame that last wrote it.
+class StreamBuffer
+{
+public:
+    static constexpr unsigned int FRAMES = 3;
+
+    explicit StreamBuffer(size_t segmentSize = 8 << 20);
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer &) = delete;
+    StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+    // waits for the segment about to be reused, call before the first Allocate of a frame
+    void BeginFrame();
+    void EndFrame();
+
+    // alignment must be a power of two
+    StreamAllocation Allocate(size_t size, size_t alignment = 16);
+    void Commit(StreamAllocation &allocation);
+
+    bool isPersistent() const { return persistent; }
+    size_t getSegmentSize() const { return segmentSize; }
+    // bytes handed out in the current frame
+    size_t getFrameUsage() const { return head - segmentStart(); }
+
+private:
+    unsigned int buffer = 0;
+    size_t segmentSize;
+    bool persistent = false;
+    char *mapped = nullptr;
+
+    unsigned int segment = 0;
+    size_t head = 0;
+    GLsync fences[FRAMES] = {};
+    bool frameOpen = false;
+
+    void create();
+    void destroy();
+    size_t segmentStart() const { return segment * segmentSize; }
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <iostream>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+// GL_UNIFORM_BUFFER attached to a fixed binding point, programs pick it up
+// through glUniformBlockBinding (see Shader::createProgram).
+class UniformBuffer
+{
+public:
+    unsigned int ID;
+    unsigned int bindingPoint;
+
+    UniformBuffer(unsigned int size, unsigned int bindingPoint);
+    void SetData(const void *data, unsigned int size, unsigned int offset = 0);
+    void Bind();
+    void UnBind();
+};
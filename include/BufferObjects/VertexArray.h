@@ -11,6 +11,8 @@ public:
     unsigned int ID;
 
     VertexArray();
+    // wraps a VAO owned elsewhere (GeometryArena), nothing is created
+    explicit VertexArray(unsigned int existingID) : ID(existingID) {}
     void AddAttribLayout(unsigned int index, int count, GLenum type, GLboolean normalized, GLsizei stride, const void *pointer);
     void Bind();
     void UnBind();
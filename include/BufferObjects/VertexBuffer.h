@@ -8,8 +8,10 @@
 class VertexBuffer
 {
 public:
-    unsigned int ID;
+    unsigned int ID = 0;
 
+    // no GL object, for meshes whose vertices live in a GeometryArena
+    VertexBuffer() = default;
     VertexBuffer(const void *data, unsigned int size);
     void Bind();
     void UnBind();
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include "ModelData.h"
+
+// .fmesh: a model file cooked into the exact in-memory layout the engine uses.
+//
+//   FMeshHeader
+//   FMeshEntry[meshCount]
+//   per mesh: Vertex[vertexCount], uint32_t[indexCount]   (each FMESH_ALIGNMENT aligned)
+//   meta block: texture refs, skeleton and animation tracks
+//
+// Loading maps the file and points MeshData straight at the vertex and index
+// arrays, so they go to glBufferData without being touched on the CPU. Only the
+// small meta block is decoded.
+constexpr uint32_t FMESH_VERSION = 2;
+constexpr uint32_t FMESH_ALIGNMENT = 64;
+
+struct FMeshHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t meshCount;
+    uint32_t hasAnimation;
+
+    // stamp of the source file the blob was cooked from
+    uint64_t sourceSize;
+    int64_t sourceTime;
+
+    uint64_t metaOffset;
+    uint64_t metaSize;
+
+    float globalInverseTransform[16];
+};
+
+struct FMeshEntry
+{
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+
+    // MeshData::bounds, already inflated for skinned meshes
+    float boundsMin[3];
+    float boundsMax[3];
+};
+
+class FMesh
+{
+public:
+    // where the cooked file for a source model lives, next to the source
+    static std::string cookedPath(const std::string &sourcePath);
+
+    static bool write(const std::string &path, const std::string &sourcePath, const ModelData &data);
+
+    // fails if the file is missing, malformed, from another version or older than the source
+    static bool read(const std::string &path, const std::string &sourcePath, ModelData &data);
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "UniformBlocks.h"
+#include "RenderQueue.h"
+#include "LightClusters.h"
+#include "ParticleSystem.h"
+#include "GUIDrawData.h"
+
+// one visible model mesh, the program is picked on the render thread from the features
+struct ModelDraw
+{
+    DrawPacket draw;         // instance.boneOffset is into FramePacket::boneMatrices
+    uint32_t shaderFeatures; // ShaderFeature bits of the mesh and its skinning
+};
+
+struct ParticleBatch
+{
+    ParticleEmitter *emitter;
+    size_t first, count; // into FramePacket::particles
+};
+
+// Everything the render side draws one frame from, written by the update thread
+// in SceneManager::BuildFramePacket and GUIManager::EndFrame, then only read.
+// Meshes and emitters are pointed at, not copied: they are only created and
+// destroyed through RenderThread::Run, never while a packet is being drawn.
+struct FramePacket
+{
+    uint64_t frameNumber = 0;
+    int framebufferWidth = 0, framebufferHeight = 0;
+
+    FrameData frame;
+    // built for this packet's camera, the render side only uploads them
+    LightClusters lightClusters;
+
+    // skinning matrices of every animated model, back to back
+    std::vector<glm::mat4> boneMatrices;
+    // after frustum and occlusion culling
+    std::vector<ModelDraw> modelDraws;
+    std::vector<InstanceData> lightGizmos;
+    std::vector<InstanceData> physicsShapes;
+    std::vector<ParticleInstance> particles;
+    std::vector<ParticleBatch> particleBatches;
+
+    GUIDrawData gui;
+
+    // keeps the capacity, packets are reused every other frame
+    void clear()
+    {
+        boneMatrices.clear();
+        modelDraws.clear();
+        lightGizmos.clear();
+        physicsShapes.clear();
+        particles.clear();
+        particleBatches.clear();
+        gui.clear();
+    }
+};
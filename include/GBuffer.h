@@ -0,0 +1,48 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+// texture units the lighting pass reads the G-buffer from, below the light lists
+constexpr unsigned int GBUFFER_ALBEDO_UNIT = 9;
+constexpr unsigned int GBUFFER_NORMAL_UNIT = 10;
+constexpr unsigned int GBUFFER_DEPTH_UNIT = 11;
+
+// Render targets of the deferred path, 12 bytes per pixel:
+//   albedo   RGBA8, rgb albedo, a specular strength
+//   normal   RG16, octahedral encoded world normal remapped to 0..1
+//   depth    DEPTH_COMPONENT24, world position is rebuilt from it
+// The models are drawn into it by the usual RenderModels pass, then a single
+// full screen pass lights every pixel from the clustered light lists.
+class GBuffer
+{
+public:
+    static constexpr unsigned int BYTES_PER_PIXEL = 12;
+
+    GBuffer() = default;
+    ~GBuffer();
+
+    GBuffer(const GBuffer &) = delete;
+    GBuffer &operator=(const GBuffer &) = delete;
+
+    // binds and clears the targets, (re)creating them when the size changed
+    void Begin(int width, int height);
+    // back to target, the default framebuffer unless drawing offscreen
+    void End(unsigned int target = 0);
+
+    void BindTextures();
+    // one triangle covering the viewport, the vertex shader builds it from gl_VertexID
+    void DrawFullscreen();
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+private:
+    unsigned int framebuffer = 0;
+    unsigned int textures[3] = {}; // albedo, normal, depth
+    unsigned int emptyVAO = 0;
+    int width = 0, height = 0;
+
+    bool create(int width, int height);
+    void destroy();
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+// glad is generated for 3.3 core, newer entry points are fetched by hand
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+typedef void(APIENTRYP PFN_glMultiDrawElementsIndirect)(GLenum mode, GLenum type, const void *indirect, GLsizei drawcount, GLsizei stride);
+typedef void(APIENTRYP PFN_glBufferStorage)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+typedef void(APIENTRYP PFN_glGetProgramBinary)(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+typedef void(APIENTRYP PFN_glProgramBinary)(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+typedef void(APIENTRYP PFN_glProgramParameteri)(GLuint program, GLenum pname, GLint value);
+typedef void(APIENTRYP PFN_glMaxShaderCompilerThreads)(GLuint count);
+
+// layout fixed by GL for glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand
+{
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+// Optional GL features the driver may offer above our 3.3 baseline.
+// Load() runs once after glad, every feature defaults to unavailable.
+class GLExtensions
+{
+public:
+    static int major, minor;
+
+    // GL 4.3 / ARB_multi_draw_indirect, baseInstance included
+    static bool multiDrawIndirect;
+    static PFN_glMultiDrawElementsIndirect MultiDrawElementsIndirect;
+
+    // GL 4.4 / ARB_buffer_storage, persistent mapping
+    static bool bufferStorage;
+    static PFN_glBufferStorage BufferStorage;
+
+    // GL 4.1 / ARB_get_program_binary, with at least one binary format on offer
+    static bool programBinary;
+    static PFN_glGetProgramBinary GetProgramBinary;
+    static PFN_glProgramBinary ProgramBinary;
+    static PFN_glProgramParameteri ProgramParameteri;
+
+    // KHR/ARB_parallel_shader_compile, compile and link status can be polled without blocking
+    static bool parallelShaderCompile;
+    static PFN_glMaxShaderCompilerThreads MaxShaderCompilerThreads;
+
+    static void Load();
+    static bool Has(const char *extension);
+    static bool AtLeast(int wantMajor, int wantMinor);
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+// calls that went through GLState during the last finished frame
+struct GLStateStats
+{
+    unsigned int issued = 0;
+    unsigned int skipped = 0;
+};
+
+// Shadow copy of the bits of GL state the engine changes every frame.
+// Every bind goes through here and is dropped when GL already has that value,
+// so callers can bind unconditionally instead of unbinding after themselves.
+// Anything deleting a GL object must use the Delete* helpers, a recycled
+// name would otherwise look already bound.
+//
+// Single context only. ImGui's backend saves and restores what it touches,
+// so it does not need to go through here.
+class GLState
+{
+public:
+    static constexpr unsigned int MAX_TEXTURE_UNITS = 16;
+
+    static void UseProgram(unsigned int program);
+    static void BindVertexArray(unsigned int vao);
+    // GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_TEXTURE_BUFFER
+    static void BindBuffer(GLenum target, unsigned int buffer);
+
+    static void ActiveTexture(unsigned int unit);
+    static void BindTexture(unsigned int unit, GLenum target, unsigned int texture);
+    // on whatever unit is currently active, for uploads
+    static void BindTexture(GLenum target, unsigned int texture);
+
+    static void SetBlend(bool enabled);
+    static void BlendFunc(GLenum src, GLenum dst);
+    static void PolygonMode(GLenum mode);
+
+    static void DeleteTexture(unsigned int texture);
+    static void DeleteBuffer(unsigned int buffer);
+    static void DeleteVertexArray(unsigned int vao);
+
+    // counter mode, off by default since it is only read by the overlay
+    static void SetCounting(bool enabled);
+    static bool IsCounting();
+    // rolls the counters over, call once after the frame was submitted
+    static void EndFrame();
+    static const GLStateStats &getStats();
+};
@@ -11,13 +11,18 @@
 #include "imgui_impl_opengl3.h"
 
 #include "SceneManager.h"
+#include "GUIDrawData.h"
 
 class GUIManager
 {
 public:
     GUIManager(GLFWwindow *window, SceneManager &scene, int windowWidth, int windowHeight);
+    // builds this frame's windows, update thread
     void Start();
-    void Render();
+    // ends the ImGui frame and copies its output into out, which stays valid after the next Start()
+    void EndFrame(GUIDrawData &out);
+    // with the context current
+    static void Render(GUIDrawData &drawData);
     void Shutdown();
 
 private:
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+
+#include "imgui.h"
+
+// A copy of one frame's ImGui output. ImGui::GetDrawData() points into the
+// ImGui context and is rebuilt by the next NewFrame(), so the render thread
+// draws from this instead. The draw lists are kept and refilled every frame.
+// Texture references are resolved to GL names while copying, texture updates
+// must have been done before (see GUIManager::EndFrame).
+class GUIDrawData
+{
+public:
+    GUIDrawData() = default;
+    ~GUIDrawData();
+
+    GUIDrawData(const GUIDrawData &) = delete;
+    GUIDrawData &operator=(const GUIDrawData &) = delete;
+
+    void copy(const ImDrawData &source);
+    void clear();
+
+    ImDrawData *get() { return &data; }
+    bool isValid() const { return data.Valid && data.CmdListsCount > 0; }
+
+private:
+    ImDrawData data;
+    std::vector<ImDrawList *> lists;
+};
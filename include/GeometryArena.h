@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "ModelData.h"
+
+// where a mesh lives inside the arena, indices stay relative to baseVertex
+struct GeometryRange
+{
+    uint32_t baseVertex = 0;
+    uint32_t vertexCount = 0;
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+};
+
+// One vertex buffer, one index buffer and one VAO shared by every imported
+// mesh (they all use the Vertex layout), so switching between submeshes never
+// switches vertex state and a whole material can go out as one multi-draw.
+// Ranges are handed out first-fit from free lists; when a buffer runs out it
+// is reallocated at twice the size and the old contents copied over on the GPU.
+class GeometryArena
+{
+public:
+    GeometryArena() = default;
+    ~GeometryArena();
+
+    GeometryArena(const GeometryArena &) = delete;
+    GeometryArena &operator=(const GeometryArena &) = delete;
+
+    // false and nothing allocated when the buffers cannot grow far enough
+    bool Allocate(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount, GeometryRange &range);
+    void Free(const GeometryRange &range);
+
+    // created on first use, stays valid when the buffers grow
+    unsigned int getVAO();
+
+    size_t vertexCapacity() const { return vertices.capacity; }
+    size_t indexCapacity() const { return indices.capacity; }
+    size_t vertexUsed() const { return vertices.used; }
+    size_t indexUsed() const { return indices.used; }
+
+private:
+    struct Block
+    {
+        uint32_t offset, size;
+    };
+
+    // free list over one buffer, in elements
+    struct Region
+    {
+        unsigned int buffer = 0;
+        uint32_t capacity = 0, used = 0;
+        std::vector<Block> free; // sorted by offset, never adjacent
+
+        bool allocate(uint32_t size, uint32_t &offset);
+        void release(uint32_t offset, uint32_t size);
+        void grow(uint32_t newCapacity);
+    };
+
+    unsigned int VAO = 0;
+    Region vertices, indices;
+
+    bool reserve(Region &region, GLenum target, size_t elementSize, uint32_t size);
+    void attachBuffers();
+};
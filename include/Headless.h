@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// fynix --headless [--scene Projects/x/x.fynx] [--frames 300] [--size 1280x720]
+//                  [--timestep 0.0166667] [--timings timings.json] [--dump-frames dir]
+//
+// Renders a fixed number of frames offscreen with a fixed timestep, no GUI and
+// no input, and writes the CPU time of every frame as JSON. --dump-frames also
+// writes every frame as dir/frame_00000.ppm for image diffing.
+struct HeadlessOptions
+{
+    bool enabled = false;
+    std::string timingsPath = "timings.json";
+    std::string dumpDirectory; // empty: no frame dumps
+    int frames = 300;
+    int width = 1280, height = 720;
+    float timestep = 1.0f / 60.0f;
+
+    // picks the --headless options out of argv, false and a message on a malformed value
+    bool parse(int argc, char **argv);
+};
+
+// per frame, in milliseconds
+struct FrameTiming
+{
+    double updateMs = 0.0; // update thread: simulation and building the packet
+    double waitMs = 0.0;   // update thread: waiting for a free packet
+    double renderMs = 0.0; // render side: GL submission, without the frame dump
+    double frameMs = 0.0;  // update thread: the whole iteration
+};
+
+// Collected during a headless run and written once at the end: the options,
+// every frame's timings and mean / median / 95th percentile / max of each.
+class TimingLog
+{
+public:
+    // sized up front, the render thread writes its part of each frame concurrently
+    explicit TimingLog(int frames) : frames(frames) {}
+
+    FrameTiming &operator[](size_t frame) { return frames[frame]; }
+
+    bool write(const std::string &path, const HeadlessOptions &options, const std::string &scenePath, bool renderThread, bool deferred) const;
+
+private:
+    std::vector<FrameTiming> frames;
+};
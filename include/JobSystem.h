@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// Fixed pool of worker threads running fire-and-forget jobs in FIFO order.
+// Jobs must not touch GL, results go back to the main thread through queues.
+class JobSystem
+{
+public:
+    // 0 picks hardware threads - 1, leaving a core for the main thread
+    explicit JobSystem(unsigned int workerCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    void submit(std::function<void()> job);
+
+    // blocks until the queue is empty and no job is running
+    void waitIdle();
+
+    // runs body(0 .. count-1) spread over the workers and the calling thread, returns when all
+    // are done. the caller keeps working through the items itself, so a worker stuck on a long
+    // job (an import) only means less help, never a stall
+    void parallelFor(unsigned int count, const std::function<void(unsigned int)> &body);
+
+    unsigned int getWorkerCount() const { return static_cast<unsigned int>(workers.size()); }
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> jobs;
+
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable allDone;
+    unsigned int running = 0;
+    bool stopping = false;
+
+    void workerLoop();
+};
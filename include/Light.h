@@ -22,13 +22,15 @@ class Light
 {
 public:
     unsigned int ID;
-    glm::vec3 position;
     glm::vec3 color = glm::vec3(1.f);
     LightType type;
+    // point and spot lights fade out at this distance, directional lights reach everything
+    float radius = 10.f;
 
-    Mesh lightMesh;
 
     Light(unsigned int id, LightType type);
 
-    void Draw(Shader &lightShader);
+    // placement of the gizmo cube, position comes from the node's world transform.
+    // SceneManager draws every gizmo as one instanced batch
+    glm::mat4 getGizmoMatrix(const glm::vec3 &worldPosition) const;
 };
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+
+#include "UniformBlocks.h"
+#include "BufferObjects/StreamBuffer.h"
+
+class JobSystem;
+
+// texture units of the light lists, below the bone palette
+constexpr unsigned int LIGHT_DATA_UNIT = 12;
+constexpr unsigned int CLUSTER_RANGE_UNIT = 13;
+constexpr unsigned int LIGHT_INDEX_UNIT = 14;
+
+struct ClusterLight
+{
+    glm::vec3 position; // world space
+    float radius;       // contribution fades to zero here
+    glm::vec3 color;
+    bool global;        // lights every fragment regardless of distance
+};
+
+// Clustered forward lighting. The view frustum is cut into TILES_X x TILES_Y
+// screen tiles and SLICES exponential depth slices ("froxels"); every frame each
+// point light is assigned to the froxels its sphere touches, one job per depth
+// slice. The result goes into the frame's StreamBuffer segment and is read by
+// the fragment shader through three texture buffers:
+//   lightData     RGBA32F, 2 texels per light: position + radius, color
+//   clusterRanges RG32UI, per froxel: first entry in lightIndices, count
+//   lightIndices  R32UI, light numbers
+// Global lights come first in lightData and are walked by every fragment.
+class LightClusters
+{
+public:
+    static constexpr int TILES_X = 16;
+    static constexpr int TILES_Y = 9;
+    static constexpr int SLICES = 24;
+    static constexpr int CLUSTER_COUNT = TILES_X * TILES_Y * SLICES;
+    // a froxel drops lights beyond this, keeps a single hot spot from blowing up the lists
+    static constexpr int MAX_LIGHTS_PER_CLUSTER = 256;
+
+    LightClusters() = default;
+    ~LightClusters();
+
+    LightClusters(const LightClusters &) = delete;
+    LightClusters &operator=(const LightClusters &) = delete;
+
+    void Build(const std::vector<ClusterLight> &lights, const glm::mat4 &view, const glm::mat4 &projection, JobSystem &jobs);
+    // writes the lists into the stream and fills in the block the shader reads them through
+    void Upload(StreamBuffer &stream, LightData &block);
+    void Bind();
+
+    size_t getLightCount() const { return ordered.size(); }
+    // false when every light is global, the shaders can then skip the cluster lookup
+    bool hasClusteredLights() const { return ordered.size() > static_cast<size_t>(globalCount); }
+    size_t getIndexCount() const { return indexCount; }
+    unsigned int getMaxPerCluster() const { return maxPerCluster; }
+
+private:
+    struct Slice
+    {
+        std::vector<uint32_t> indices;
+        std::vector<glm::uvec2> ranges; // offset into this slice's indices, count
+    };
+
+    std::vector<ClusterLight> ordered; // global lights first
+    int globalCount = 0;
+    std::vector<glm::vec4> viewSpheres; // xyz view space center, w radius
+    std::vector<Slice> slices;
+    float nearPlane = 0.1f, farPlane = 100.0f;
+    glm::mat4 projection = glm::mat4(1.0f);
+    size_t indexCount = 0;
+    unsigned int maxPerCluster = 0;
+
+    unsigned int textures[3] = {};
+    unsigned int attachedBuffer = 0;
+
+    float sliceDepth(int slice) const;
+    void buildSlice(int slice);
+};
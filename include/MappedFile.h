@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+// Read-only memory mapping of a whole file (CreateFileMapping on Windows, mmap elsewhere).
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    bool open(const std::string &path);
+    void close();
+
+    bool isOpen() const { return data != nullptr; }
+    const unsigned char *getData() const { return data; }
+    size_t getSize() const { return size; }
+
+private:
+    const unsigned char *data = nullptr;
+    size_t size = 0;
+
+#ifdef _WIN32
+    void *fileHandle = nullptr;
+    void *mappingHandle = nullptr;
+#endif
+};
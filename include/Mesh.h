@@ -11,20 +11,13 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include "ModelData.h"
 #include "Texture.h"
 #include "Shader.h"
 #include "BufferObjects/ElementBuffer.h"
 #include "BufferObjects/VertexArray.h"
 #include "BufferObjects/VertexBuffer.h"
-
-struct Vertex
-{
-    glm::vec3 postition, normal;
-    glm::vec2 texCoords;
-
-    glm::ivec4 boneIds = glm::ivec4(0);
-    glm::vec4 boneWeights = glm::vec4(0.f);
-};
+#include "GeometryArena.h"
 
 enum MeshType
 {
@@ -36,20 +29,41 @@ enum MeshType
 class Mesh
 {
 public:
-    std::vector<Vertex> vertices;
-    std::vector<unsigned int> indices;
+    // 0 for the built-in cube, which is drawn without indices
+    unsigned int indexCount = 0;
     std::vector<Texture> textures;
+    // sampler uniform per texture, built once instead of on every draw
+    std::vector<std::string> samplerNames;
+    // ShaderFeature bits that follow from the mesh alone (SHADER_TEXTURED)
+    uint32_t shaderFeatures = 0;
 
     VertexArray VAO;
     VertexBuffer VBO;
     ElementBuffer EBO;
 
-    Mesh(std::vector<Vertex> vert, std::vector<unsigned int> inds, std::vector<Texture> texs);
+    // set when the geometry was sub-allocated from a shared arena, VAO is then the
+    // arena's and VBO/EBO are empty
+    GeometryArena *arena = nullptr;
+    GeometryRange range;
+
+    // model space, invalid (never culled) until someone sets them
+    AABB bounds;
+    BoundingSphere sphere;
+    void setBounds(const AABB &box);
+
+    // uploads straight from the given arrays, they only need to live for the call
+    Mesh(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount, std::vector<Texture> texs);
+    Mesh(GeometryArena &arena, const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount, std::vector<Texture> texs);
     Mesh(MeshType type);
 
     void Draw(Shader &shader);
 
+    // deletes the GL buffers or returns the arena range, textures are not touched since they may be shared
+    void Release();
+
 private:
+    void createBuffers(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount);
+
     unsigned int cubeIndices[36] = {
         0, 1, 2, 2, 3, 0, // front
         4, 5, 6, 6, 7, 4, // back
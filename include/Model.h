@@ -2,91 +2,51 @@
 
 #include <vector>
 #include <string>
+#include <memory>
 #include <iostream>
 
-#include <assimp/scene.h>
-#include <assimp/Importer.hpp>
-#include <assimp/postprocess.h>
-#include <assimp/mesh.h>
-#include <assimp/material.h>
-
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
 
-#include "Mesh.h"
 #include "Shader.h"
 #include "Animator.h"
+#include "ModelAsset.h"
 
-struct Bone
-{
-    int id = 0;
-    std::string name = "";
-    glm::mat4 offset = glm::mat4(1.0f);
-    std::vector<Bone> children = {};
-};
-
-struct Skeleton
-{
-    Bone rootBone;
-    unsigned int boneCount = 0;
-};
-
+// A placed instance of a ModelAsset. Geometry, skeleton and clips are shared,
+// only the animation state and the resulting bone palette are per instance.
+// While the asset is still loading the instance draws its placeholder.
 class Model
 {
 public:
     unsigned int ID;
     std::string directory;
-    glm::mat4 globalInverseTransform;
     bool hasAnimation = false;
     bool physicsEnabled = false;
+    // rasterized into the occlusion buffer and never tested against it, meant for walls and large static props
+    bool occluder = false;
+
+    // first matrix of this instance in the frame packet's bone matrices, set by SceneManager
+    unsigned int paletteOffset = 0;
 
-    Model(const std::string &path, unsigned int ID);
+    Model(std::shared_ptr<ModelAsset> asset, unsigned int ID);
 
-    void Draw(Shader &shader);
+    // meshes to draw this frame: the asset's, its placeholder while loading, or none.
+    // returns whether they are skinned with this instance's palette
+    bool collectMeshes(std::vector<Mesh *> &out);
     void UpdateAnimation(float deltaTime);
 
     void seek(float time);
     Animator &getAnimator() { return animator; }
-
-    void setPosition(const glm::vec3 &pos) { position = pos; }
-    void setRotation(const glm::vec3 &rot) { rotation = rot; }
-    void setScale(const glm::vec3 &scl) { scale = scl; }
-
-    glm::vec3 getPosition() const { return position; }
-    glm::vec3 getRotation() const { return rotation; }
-    glm::vec3 getScale() const { return scale; }
-    glm::mat4 getModelMatrix() const;
+    const std::vector<glm::mat4> &getBoneMatrices() const { return finalBoneMatrices; }
+    const std::shared_ptr<ModelAsset> &getAsset() const { return asset; }
 
 private:
-    std::vector<Mesh> meshes;
-    Skeleton skeleton;
+    std::shared_ptr<ModelAsset> asset;
     Animator animator;
     std::vector<glm::mat4> finalBoneMatrices;
+    bool assetBound = false;
 
-    glm::vec3 position = glm::vec3(1.f),
-              rotation = glm::vec3(1.f),
-              scale = glm::vec3(1.f);
-
-    bool loadModel(std::string path);
-    void processNode(aiNode *node, const aiScene *scene);
-    Mesh processMesh(aiMesh *mesh, const aiScene *scene);
-
-    bool readSkeleton(Bone &boneOutput, aiNode *node, std::unordered_map<std::string, std::pair<int, glm::mat4>> &boneInfoTable);
-
-    std::vector<Texture> loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName);
-    std::vector<Texture> textures_loaded;
-
-    glm::mat4 assimpToGlmMatrix(aiMatrix4x4 mat)
-    {
-        glm::mat4 m;
-        for (int y = 0; y < 4; y++)
-        {
-            for (int x = 0; x < 4; x++)
-            {
-                m[x][y] = mat[y][x];
-            }
-        }
-        return m;
-    }
-};
\ No newline at end of file
+    // hooks the animator up once the asset finished loading
+    bool bindAsset();
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <memory>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include "Mesh.h"
+#include "Animator.h"
+#include "ModelData.h"
+
+enum class AssetState
+{
+    Loading,
+    Ready,
+    Failed
+};
+
+// Everything of a model file that is identical between instances: meshes with
+// their GPU buffers, skeleton and animation clips. Created empty by the
+// AssetCache, which fills it in once the background import has been uploaded.
+class ModelAsset
+{
+public:
+    std::string path;
+    std::vector<Mesh> meshes;
+    Skeleton skeleton;
+    std::vector<Animation> animations;
+    glm::mat4 globalInverseTransform = glm::mat4(1.0f);
+    bool hasAnimation = false;
+
+    AssetState state = AssetState::Loading;
+
+    // CPU copies of the meshes for models flagged as occluders, empty for skinned
+    // or too detailed assets
+    std::vector<OccluderMesh> occluderMeshes;
+
+    // drawn in place of the meshes while loading
+    std::shared_ptr<Mesh> placeholder;
+
+    explicit ModelAsset(const std::string &path);
+    ~ModelAsset();
+
+    // owns GL objects, so only ever shared, never copied
+    ModelAsset(const ModelAsset &) = delete;
+    ModelAsset &operator=(const ModelAsset &) = delete;
+
+    bool isReady() const { return state == AssetState::Ready; }
+
+    // reads the cooked .fmesh next to path, importing and cooking it first if it is missing or stale.
+    // CPU only, runs on worker threads
+    static bool loadData(const std::string &path, ModelData &data);
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "Animator.h"
+#include "Bounds.h"
+#include "MappedFile.h"
+
+struct Vertex
+{
+    glm::vec3 postition, normal;
+    glm::vec2 texCoords;
+
+    glm::ivec4 boneIds = glm::ivec4(0);
+    glm::vec4 boneWeights = glm::vec4(0.f);
+};
+
+// written to .fmesh files as is
+static_assert(sizeof(Vertex) == 64, "Vertex layout changed, bump FMESH_VERSION");
+
+struct Bone
+{
+    int id = 0;
+    std::string name = "";
+    glm::mat4 offset = glm::mat4(1.0f);
+    std::vector<Bone> children = {};
+};
+
+struct Skeleton
+{
+    Bone rootBone;
+    unsigned int boneCount = 0;
+};
+
+struct MaterialTexture
+{
+    std::string path;
+    std::string type; // "texture_diffuse", "texture_specular"
+    unsigned int unit = 0;
+};
+
+// Geometry of one mesh. The arrays either live in ModelData's storage (fresh
+// import) or point straight into a mapped .fmesh file.
+struct MeshData
+{
+    const Vertex *vertices = nullptr;
+    uint32_t vertexCount = 0;
+    const uint32_t *indices = nullptr;
+    uint32_t indexCount = 0;
+    std::vector<MaterialTexture> textures;
+
+    // model space, for skinned meshes grown to cover every pose of every animation
+    AABB bounds;
+};
+
+// positions and triangles kept on the CPU for the software occlusion rasterizer
+struct OccluderMesh
+{
+    std::vector<glm::vec3> positions;
+    std::vector<uint32_t> indices;
+};
+
+// CPU side result of loading a model file, everything the GPU upload needs and
+// nothing that touches GL, so it can be produced anywhere.
+struct ModelData
+{
+    std::vector<MeshData> meshes;
+    Skeleton skeleton;
+    std::vector<Animation> animations;
+    glm::mat4 globalInverseTransform = glm::mat4(1.0f);
+    bool hasAnimation = false;
+
+    // backing memory for the MeshData pointers
+    std::vector<std::vector<Vertex>> vertexStorage;
+    std::vector<std::vector<uint32_t>> indexStorage;
+    MappedFile mapping;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include <assimp/scene.h>
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/mesh.h>
+#include <assimp/material.h>
+
+#include "ModelData.h"
+
+// Runs Assimp on a source model file (.gltf, .glb, ...) and converts the result
+// into ModelData. Only used to cook .fmesh files or when no cooked file exists.
+class ModelImporter
+{
+public:
+    bool import(const std::string &path, ModelData &output);
+
+private:
+    ModelData *data = nullptr;
+
+    void processNode(aiNode *node, const aiScene *scene);
+    void processMesh(aiMesh *mesh, const aiScene *scene);
+
+    bool readSkeleton(Bone &boneOutput, aiNode *node, std::unordered_map<std::string, std::pair<int, glm::mat4>> &boneInfoTable);
+    void loadAnimations(const aiScene *scene);
+    // grows the bind pose bounds of skinned meshes to cover every animation
+    void inflateSkinnedBounds();
+
+    std::vector<MaterialTexture> loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName);
+
+    static glm::vec3 assimpToGlmVec3(const aiVector3D &vec) { return glm::vec3(vec.x, vec.y, vec.z); }
+    static glm::quat assimpToGlmQuat(const aiQuaternion &quat) { return glm::quat(quat.w, quat.x, quat.y, quat.z); }
+
+    static glm::mat4 assimpToGlmMatrix(aiMatrix4x4 mat)
+    {
+        glm::mat4 m;
+        for (int y = 0; y < 4; y++)
+        {
+            for (int x = 0; x < 4; x++)
+            {
+                m[x][y] = mat[y][x];
+            }
+        }
+        return m;
+    }
+};
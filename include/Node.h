@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+
+#include "SlotMap.h"
+
+enum class NodeType
+{
+    Root,
+    Model,
+    Light,
+    Particles,
+    RigidBody,
+    Empty
+};
+
+// Scene graph node. Children are an intrusive doubly linked sibling list, so a
+// node never owns a heap allocation of its own and nodes can live in a NodePool.
+struct Node
+{
+    unsigned int ID;
+    std::string name;
+
+    NodeType type;
+
+    Node *parent = nullptr;
+    Node *firstChild = nullptr;
+    Node *lastChild = nullptr;
+    Node *prevSibling = nullptr;
+    Node *nextSibling = nullptr;
+
+    // handle of this node's entry in models / lights / particleEmitters
+    SlotHandle component = {};
+
+    bool hasChildren() const { return firstChild != nullptr; }
+
+    // appends child as the last child of this node, detaching it from its old parent first
+    void appendChild(Node *child)
+    {
+        child->detach();
+        child->parent = this;
+        child->prevSibling = lastChild;
+        if (lastChild)
+            lastChild->nextSibling = child;
+        else
+            firstChild = child;
+        lastChild = child;
+    }
+
+    // unlinks this node from its parent's child list, its own children stay attached
+    void detach()
+    {
+        if (!parent)
+            return;
+
+        if (prevSibling)
+            prevSibling->nextSibling = nextSibling;
+        else
+            parent->firstChild = nextSibling;
+
+        if (nextSibling)
+            nextSibling->prevSibling = prevSibling;
+        else
+            parent->lastChild = prevSibling;
+
+        parent = prevSibling = nextSibling = nullptr;
+    }
+};
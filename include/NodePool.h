@@ -0,0 +1,31 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <string>
+
+#include "Node.h"
+
+// Block allocator for scene graph nodes. Nodes are carved out of fixed-size
+// blocks (addresses stay stable), freed nodes go on a free list, and reset()
+// releases every node at once while keeping the blocks around for the next scene.
+class NodePool
+{
+public:
+    explicit NodePool(size_t nodesPerBlock = 1024);
+
+    Node *create(unsigned int ID, const std::string &name, NodeType type);
+    void destroy(Node *node);
+    void reset();
+
+    size_t size() const { return liveCount; }
+    size_t capacity() const { return blocks.size() * nodesPerBlock; }
+
+private:
+    size_t nodesPerBlock;
+    std::vector<std::unique_ptr<Node[]>> blocks;
+    size_t usedBlocks = 0;
+    size_t blockCursor = 0;
+    std::vector<Node *> freeList;
+    size_t liveCount = 0;
+};
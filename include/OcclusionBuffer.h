@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "Bounds.h"
+
+class JobSystem;
+
+// Low resolution software depth buffer for occlusion culling, all on the CPU.
+// A handful of occluder meshes are rasterized into it (4 pixels per SSE
+// instruction, the edge tests form the write mask), split into horizontal bands
+// that run on the JobSystem. A max-depth pyramid is then built over it, and a
+// box is hidden when its nearest point lies behind the farthest occluder depth in
+// every pyramid texel it covers.
+class OcclusionBuffer
+{
+public:
+    static constexpr int WIDTH = 256;
+    static constexpr int HEIGHT = 128;
+    static constexpr int BAND_HEIGHT = 16;
+
+    OcclusionBuffer();
+
+    // clears the depth and the occluder list for a new view
+    void Begin(const glm::mat4 &viewProjection);
+    // transforms the triangles right away, the arrays only need to live for the call
+    void AddOccluder(const glm::vec3 *positions, const uint32_t *indices, size_t indexCount, const glm::mat4 &model);
+    // fills the depth buffer and the pyramid, on the workers when jobs is given
+    void Rasterize(JobSystem *jobs = nullptr);
+
+    // false only when the box is certainly behind the occluders
+    bool isVisible(const AABB &worldBox) const;
+
+    size_t getTriangleCount() const { return triangles.size(); }
+    const float *getDepth() const { return pyramid[0].data(); }
+
+private:
+    struct ScreenTriangle
+    {
+        glm::vec3 v[3]; // pixels, depth in 0..1
+        int minY, maxY;
+    };
+
+    glm::mat4 viewProjection = glm::mat4(1.0f);
+    std::vector<ScreenTriangle> triangles;
+    std::vector<glm::vec4> clipScratch;
+
+    // level 0 is the depth buffer, every level above halves both sides keeping the max
+    std::vector<std::vector<float>> pyramid;
+    bool rasterized = false;
+
+    void rasterizeBand(int firstRow, int endRow);
+    void buildPyramid();
+};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include <string>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+// Color (RGBA8) and depth (DEPTH24_STENCIL8) renderbuffers standing in for the
+// window's back buffer in headless runs, where there is no window to draw to.
+// Single sampled, so two runs of the same frame read back the same pixels.
+class OffscreenTarget
+{
+public:
+    OffscreenTarget() = default;
+    ~OffscreenTarget();
+
+    OffscreenTarget(const OffscreenTarget &) = delete;
+    OffscreenTarget &operator=(const OffscreenTarget &) = delete;
+
+    bool Create(int width, int height);
+    // binds it as the draw and read framebuffer and covers it with the viewport
+    void Bind();
+
+    // tightly packed RGB rows, top row first
+    void ReadPixels(std::vector<unsigned char> &rgb);
+    // binary PPM (P6), readable by most image diff tools
+    static bool WritePPM(const std::string &path, int width, int height, const std::vector<unsigned char> &rgb);
+
+    unsigned int getFramebuffer() const { return framebuffer; }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+
+private:
+    unsigned int framebuffer = 0;
+    unsigned int renderbuffers[2] = {}; // color, depth
+    int width = 0, height = 0;
+
+    void destroy();
+};
@@ -5,6 +5,7 @@
 
 #include "BufferObjects/VertexBuffer.h"
 #include "BufferObjects/VertexArray.h"
+#include "BufferObjects/StreamBuffer.h"
 #include "shader.h"
 
 #include "Light.h"
@@ -20,11 +21,19 @@ struct Particle
         : Position(0.0f), Velocity(0.0f), Color(1.0f), Life(0.0f) {}
 };
 
+// what the particle shader reads per instance, locations 1 and 2
+struct ParticleInstance
+{
+    glm::vec4 positionSize; // xyz position, w size
+    glm::vec4 color;
+};
+static_assert(sizeof(ParticleInstance) == 8 * sizeof(float), "ParticleInstance layout is mirrored by the instance attributes");
+
 class ParticleEmitter
 {
 public:
     unsigned int ID, maxParticles;
-    glm::vec3 Position = glm::vec3(0.f);
+    glm::vec3 Position = glm::vec3(0.f); // world space spawn origin, synced from the node transform
     glm::vec4 Color = glm::vec4(1.0f, 0.5f, 0.2f, 1.0f);
     Shader shader;
 
@@ -32,7 +41,10 @@ public:
     ParticleEmitter(Shader shader, unsigned int maxParticles, unsigned int ID);
 
     void Update(float dt);
-    void Draw();
+    // appends the live particles, returns how many
+    size_t CopyInstances(std::vector<ParticleInstance> &out) const;
+    // instance data goes into this frame's stream segment
+    void Draw(StreamBuffer &stream, const ParticleInstance *instances, size_t count);
 
     void SpawnParticle(Particle particle);
 
@@ -40,10 +52,7 @@ private:
     std::vector<Particle> particles;
     unsigned int lastUsedParticle;
 
-    std::vector<float> particleData;
-
     unsigned int VAO;
-    unsigned int instanceVBO; // VBO for instance data
 
     void init();
 
@@ -23,13 +23,18 @@ public:
     ~PhysicsEngine();
 
     void update(float deltaTime);
-    void Draw(Shader &shader);
+    // debugMesh placement for a body, scaled to its collider; drawn instanced by SceneManager
+    glm::mat4 getDebugMatrix(btRigidBody *body, const glm::mat4 &worldMatrix);
 
     btDiscreteDynamicsWorld *getDynamicsWorld();
 
     btRigidBody *createBoxRigidBody(glm::vec3 position, glm::vec3 size, float mass);
     void deleteRigidBody(btRigidBody *body);
 
+    // world transform of a body without collider scale, and the reverse (scale is stripped)
+    glm::mat4 getBodyTransform(btRigidBody *body);
+    void setBodyTransform(btRigidBody *body, const glm::mat4 &worldMatrix);
+
     void setGravity(int gravity) { m_dynamicsWorld->setGravity(btVector3(0, -gravity, 0)); }
 
 private:
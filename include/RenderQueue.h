@@ -0,0 +1,134 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+
+#include "Mesh.h"
+#include "Shader.h"
+#include "GLExtensions.h"
+#include "BufferObjects/StreamBuffer.h"
+
+enum class RenderPass : uint8_t
+{
+    Opaque = 0,
+    Transparent = 1,
+};
+
+// state changes of one frame, see RenderQueue::getStats
+struct RenderStats
+{
+    unsigned int drawCalls = 0;
+    unsigned int instances = 0;
+    unsigned int programSwitches = 0;
+    unsigned int textureBinds = 0;
+    unsigned int vertexArrayBinds = 0;
+};
+
+// Per-instance vertex attributes, written into the StreamBuffer once per flush.
+// Shaders read them at locations 5-13:
+//   5-8 model, 9-11 normal matrix, 12 color, 13 bone offset (int)
+struct InstanceData
+{
+    glm::mat4 model = glm::mat4(1.0f);
+    glm::vec4 normalMatrix[3] = {glm::vec4(1, 0, 0, 0), glm::vec4(0, 1, 0, 0), glm::vec4(0, 0, 1, 0)};
+    glm::vec4 color = glm::vec4(1.0f);
+    int boneOffset = -1; // -1 when not skinned
+    int pad[3] = {};
+};
+static_assert(sizeof(InstanceData) == 144, "InstanceData layout is mirrored by the instance attributes");
+
+constexpr unsigned int INSTANCE_ATTRIB_FIRST = 5;
+
+// one mesh draw, everything Flush() needs without going back to the scene
+struct DrawPacket
+{
+    Mesh *mesh = nullptr;
+    Shader *shader = nullptr;
+    InstanceData instance;
+
+    void setTransform(const glm::mat4 &model, const glm::mat3 &normalMatrix);
+};
+
+// Collects draws as compact packets and submits them ordered by a 64-bit key.
+// Draws sharing a program, then a texture set, then a mesh end up next to each
+// other: binds between them are skipped and every run of the same mesh becomes
+// a single instanced draw.
+// Meshes in the GeometryArena additionally share their VAO, so with multi-draw
+// indirect every run of arena meshes with the same program and textures goes
+// out as one glMultiDrawElementsIndirect. Their per-instance data is reached
+// through baseInstance. Without it they fall back to one
+// glDrawElementsInstancedBaseVertex per mesh.
+//
+// key layout, most significant first:
+//   pass (4) | program (10) | material (18) | mesh (16) | depth (16)
+// Opaque draws go front to back inside a mesh, transparent back to front.
+class RenderQueue
+{
+public:
+    // distance mapped onto the depth bits, anything further shares the last bucket
+    static constexpr float MAX_SORT_DEPTH = 1000.0f;
+
+    void Begin(const glm::vec3 &camPos);
+    void Submit(const DrawPacket &packet, RenderPass pass = RenderPass::Opaque);
+
+    // sorts and issues everything submitted since Begin(), per-instance data and
+    // indirect commands are written straight into the stream
+    void Flush(StreamBuffer &stream);
+
+    // rolls the counters of every flush this frame over to getStats()
+    void EndFrame();
+
+    size_t size() const { return packets.size(); }
+
+    // what the flushes of last frame issued, and what submission order would have cost
+    const RenderStats &getStats() const { return sortedStats; }
+    const RenderStats &getUnsortedStats() const { return unsortedStats; }
+
+    static uint64_t MakeKey(RenderPass pass, unsigned int program, uint32_t material, unsigned int mesh, float depth);
+
+private:
+    struct SortEntry
+    {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    // consecutive sorted entries drawing the same mesh with the same program
+    struct Batch
+    {
+        uint32_t first, count;
+        Mesh *mesh;
+        Shader *shader;
+        uint32_t command; // into commands, arena meshes only
+    };
+
+    glm::vec3 camPos = glm::vec3(0.0f);
+    std::vector<DrawPacket> packets;
+    std::vector<SortEntry> entries, scratch;
+    std::vector<Batch> batches;
+
+    // this flush's slices of the stream
+    StreamAllocation instanceData, commandData;
+    bool multiDrawReady = false;
+
+    RenderStats sortedStats, unsortedStats;
+    RenderStats frameSorted, frameUnsorted;
+
+    void RadixSort();
+    void BuildBatches();
+    bool WriteInstances(StreamBuffer &stream);
+    void WriteCommands(StreamBuffer &stream);
+    // walks the batches in order, merging what can share a draw and eliding
+    // redundant binds; only counts when issue is false
+    void Replay(bool issue, RenderStats &stats);
+    bool CanMultiDraw(const Batch &batch) const;
+    static bool SameTextures(const Mesh &a, const Mesh &b);
+    void PointInstanceAttribs(size_t firstInstance);
+
+    static uint32_t MaterialKey(const Mesh &mesh);
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "FramePacket.h"
+
+// Owns the GL context and draws frame packets on a thread of its own, so the
+// update thread simulates frame N+1 while frame N is submitted.
+//
+// There are two packets. The update thread fills one between BeginPacket() and
+// SubmitPacket() while the render thread draws the other; BeginPacket() only
+// waits when the render thread is still on the packet it is about to reuse.
+// Anything else needing GL on the update thread goes through Run(), which the
+// render thread executes between two frames while the caller waits, after
+// every packet submitted before it has been drawn.
+//
+// Without Start() everything happens on the calling thread: SubmitPacket()
+// draws the packet at once and Run() calls straight through.
+class RenderThread
+{
+public:
+    using DrawFunction = std::function<void(FramePacket &)>;
+
+    RenderThread() = default;
+    ~RenderThread();
+
+    RenderThread(const RenderThread &) = delete;
+    RenderThread &operator=(const RenderThread &) = delete;
+
+    // what draws a packet, called on the thread holding the context
+    void SetDrawFunction(DrawFunction function);
+
+    // moves the window's context, current on the calling thread, to the render thread
+    void Start(GLFWwindow *window);
+    // draws what was submitted and makes the context current on the calling thread again
+    void Stop();
+
+    // the packet to fill next, cleared
+    FramePacket &BeginPacket();
+    void SubmitPacket();
+
+    // runs fn with the context current and returns once it has
+    void Run(const std::function<void()> &fn);
+
+    bool isRunning() const { return thread.joinable(); }
+    // update thread time spent in BeginPacket() last frame, > 0 means the render side is the bottleneck
+    float getWaitMs() const { return waitMs; }
+
+private:
+    FramePacket packets[2];
+    DrawFunction draw;
+    GLFWwindow *window = nullptr;
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;     // to the render thread
+    std::condition_variable finished; // to the update thread
+
+    unsigned int filling = 0; // update thread side
+    uint64_t frameNumber = 0;
+    bool submitted[2] = {};   // handed over and not drawn yet
+    const std::function<void()> *task = nullptr;
+    bool stopping = false;
+    float waitMs = 0.0f;
+
+    void threadLoop();
+};
@@ -4,6 +4,8 @@
 #include <vector>
 #include <iostream>
 #include <string>
+#include <mutex>
+#include <functional>
 #include <dirent.h>
 
 #include <json.hpp>
@@ -14,26 +16,41 @@
 #include "ShaderManager.h"
 
 #include "PhysicsEngine.h"
-
-enum class NodeType
+#include "SlotMap.h"
+#include "TransformStore.h"
+#include "Node.h"
+#include "NodePool.h"
+#include "AssetCache.h"
+#include "JobSystem.h"
+#include "UniformBlocks.h"
+#include "BufferObjects/UniformBuffer.h"
+#include "BufferObjects/StreamBuffer.h"
+#include "BonePalette.h"
+#include "RenderQueue.h"
+#include "Bounds.h"
+#include "AABBTree.h"
+#include "OcclusionBuffer.h"
+#include "LightClusters.h"
+#include "GLState.h"
+#include "FramePacket.h"
+
+class GBuffer;
+class RenderThread;
+
+struct CullStats
 {
-    Root,
-    Model,
-    Light,
-    Particles,
-    RigidBody,
-    Empty
+    unsigned int visible = 0;
+    unsigned int culled = 0;   // outside the frustum
+    unsigned int occluded = 0; // inside, but behind an occluder
 };
 
-struct Node
+// what the render side reported for its last finished frame, see SceneManager::getFrameStats
+struct FrameStats
 {
-    unsigned int ID;
-    std::string name;
-
-    NodeType type;
-
-    Node *parent = nullptr;
-    std::vector<Node *> children;
+    RenderStats sorted, unsorted;
+    GLStateStats glState;
+    bool countingGLState = false;
+    size_t compilingShaders = 0;
 };
 
 class SceneManager
@@ -41,29 +58,62 @@ class SceneManager
 public:
     unsigned int nextID;
 
-    Node *root = new Node({0,
-                           "Root",
-                           NodeType::Root,
-                           nullptr,
-                           {}});
+    // every Node is allocated from here, reloading a scene resets the pool in one go
+    NodePool nodePool;
+
+    Node *root = nullptr;
+    // indexed by node ID, deleted nodes leave a nullptr behind
     std::vector<Node *> nodes;
-    std::vector<Model> models;
-    std::vector<Light> lights;
-    std::vector<ParticleEmitter> particleEmitters;
+
+    // shared vertex/index storage of all imported meshes, declared before
+    // everything holding meshes so they can hand their ranges back on destruction
+    GeometryArena geometry;
+
+    SlotMap<Model> models;
+    SlotMap<Light> lights;
+    SlotMap<ParticleEmitter> particleEmitters;
     std::unordered_map<unsigned int, btRigidBody *> rigidBodies;
 
+    // background work (model imports), declared before everything that submits to it
+    JobSystem jobs;
+
+    // imported model files shared by every Model instance of the same path
+    AssetCache assets{jobs, geometry};
+
+    // local/world transform of every node, keyed by node ID
+    TransformStore transforms;
+
+    // sorted, instanced draws of the frame, refilled by each Render* pass. render side only
+    RenderQueue renderQueue;
+
+    // world bounds of every model, light and emitter, items are node IDs.
+    // kept in sync with the transforms by Update()
+    AABBTree spatial;
+
+    // ShaderManager is used from the render side only
     ShaderManager *sm = nullptr;
     PhysicsEngine *physics = nullptr;
+    // set while frames are drawn on their own thread, see withContext()
+    RenderThread *renderThread = nullptr;
 
     bool drawLights = true,
          drawPhysics = true,
-         simulate = false;
+         simulate = false,
+         frustumCulling = true,
+         occlusionCulling = true;
+
+    // models go through a G-buffer and one lighting pass instead of the forward
+    // shader, picked once at startup with --deferred
+    bool deferredShading = false;
 
     std::string nodeTypeToString(NodeType type);
     NodeType stringToNodeType(const std::string &str);
 
     SceneManager(const std::string &projectPath);
 
+    // Adding and deleting nodes, and loading a scene, create and free GL objects:
+    // with a render thread they must be called through withContext().
+
     // add a light node to parent
     void addToParent(std::string &name, NodeType type, unsigned int parentID, LightType lightType);
 
@@ -79,10 +129,40 @@ public:
     // add any other node to parent
     void addToParent(std::string &name, NodeType type, unsigned int parentID);
 
-    void RenderModels(Shader &shader, float deltaTime);
-    void RenderLights(Shader &shader);
-    void RenderParticles(float dt);
-    void RenderPhysics(float dt, Shader &shader);
+    // runs fn with the GL context current: on the render thread between two frames while
+    // this thread waits, or right here when there is no render thread
+    void withContext(const std::function<void()> &fn);
+
+    // update side, once per frame in this order
+
+    // finishes uploads, steps physics, resolves world transforms, advances animations and particles
+    void Update(float deltaTime);
+    // culls and copies everything the render side draws this frame into packet
+    void BuildFramePacket(FramePacket &packet, const glm::mat4 &view, const glm::mat4 &projection, const glm::vec3 &camPos);
+
+    // render side, with the context current
+
+    // uploads the packet's camera block, light lists and skinning matrices
+    void BeginFrame(FramePacket &packet);
+    // shaderName is a ShaderManager variant set, each mesh draws with the variant its features pick
+    void RenderModels(const FramePacket &packet, const std::string &shaderName);
+    // lights the G-buffer RenderModels filled from the cluster lists, writes color and depth to the bound framebuffer
+    void RenderDeferredLighting(const FramePacket &packet, const std::string &shaderName, GBuffer &gbuffer);
+    void RenderLights(const FramePacket &packet, Shader &shader);
+    void RenderParticles(const FramePacket &packet);
+    void RenderPhysics(const FramePacket &packet, Shader &shader);
+
+    // fences this frame's stream segment and publishes the render stats, call after the last draw
+    void EndFrame();
+
+    // render stats of the last finished frame, safe to read from the update side
+    FrameStats getFrameStats() const;
+
+    // model meshes kept and dropped by the culling tests last frame
+    const CullStats &getCullStats() const { return cullStats; }
+    size_t getOccluderTriangleCount() const { return occlusion.getTriangleCount(); }
+    // light lists of the last built packet, nullptr before the first
+    const LightClusters *getLightClusters() const { return lightClusters; }
 
     void deleteNode(unsigned int ID);
 
@@ -99,4 +179,55 @@ public:
 private:
     const std::string projectPath;
     std::string projectName;
+
+    // update side
+
+    // camera frustum of the packet being built
+    Frustum frustum;
+    CullStats cullStats;
+    // depth of the occluder models, rasterized on the job system before the models are culled
+    OcclusionBuffer occlusion;
+    std::vector<ClusterLight> clusterLights;
+    const LightClusters *lightClusters = nullptr;
+    std::vector<Mesh *> drawMeshes;
+    // per node ID, set for the nodes whose spatial proxy the frustum query returned
+    std::vector<uint8_t> inFrustum;
+
+    // render side
+
+    // per-frame std140 blocks, created on first use and only rewritten when their contents change
+    std::unique_ptr<UniformBuffer> frameUBO;
+    std::unique_ptr<UniformBuffer> lightUBO;
+    FrameData lastFrameData = {};
+    LightData lastLightData = {};
+
+    // per-frame GPU data (instances, bone palettes, particles, light lists) is written into this ring
+    StreamBuffer stream;
+
+    // skinning matrices of the frame, written by BeginFrame
+    BonePalette bonePalette;
+    // where the packet's first bone matrix landed in the palette
+    unsigned int paletteBase = 0;
+    // shared by every light gizmo, created on first use
+    std::unique_ptr<Mesh> gizmoCube;
+
+    mutable std::mutex statsMutex;
+    FrameStats frameStats;
+
+    // spatial proxy per node ID, settled once the bounds no longer depend on a loading asset
+    struct SpatialProxy
+    {
+        uint32_t proxy = AABBTree::NONE;
+        bool settled = false;
+    };
+    std::vector<SpatialProxy> spatialProxies;
+
+    void registerNode(Node *node);
+    void updateParticles(float deltaTime);
+    void collectModels(FramePacket &packet);
+    void uploadFrameData(const FrameData &data);
+    void uploadLightData(LightClusters &clusters);
+    void updateSpatial();
+    void placeProxy(unsigned int nodeID, const AABB &worldBox, bool settled);
+    void removeProxy(unsigned int nodeID);
 };
\ No newline at end of file
@@ -8,6 +8,25 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <glm/glm.hpp>
+
+#include "UniformCache.h"
+
+class ShaderCache;
+
+// compile time features of a shader variant, each set bit becomes a #define
+// right after the #version line, see ShaderManager::addShaderVariants
+enum ShaderFeature : uint32_t
+{
+    SHADER_SKINNED = 1 << 0,          // bone palette skinning in the vertex shader
+    SHADER_TEXTURED = 1 << 1,         // samples texture_diffuse0, plain white otherwise
+    SHADER_CLUSTERED_LIGHTS = 1 << 2, // walks the cluster light lists, global lights only otherwise
+};
+constexpr uint32_t SHADER_FEATURE_COUNT = 3;
+
+// "SKINNED", "TEXTURED", ... the name of the define of a single feature bit
+const char *shaderFeatureName(uint32_t feature);
+
 enum class UniformType : uint8_t
 {
     Int = 0x01,
@@ -28,14 +47,59 @@ class Shader
 public:
     unsigned int ID, vertexShaderID, fragmentShaderID;
     const char *Name;
+    // set by submit when the program came from the binary cache
+    bool cached = false;
+    // set by finish, ID can be used from then on
+    bool ready = false;
 
-    Shader(const char *Name, const char *vertex_shader_src, const char *fragment_shader_src);
+    // only read the sources, nothing is compiled before createProgram. defines are
+    // inserted after the #version line of both stages
+    Shader(const char *Name, const char *vertex_shader_src, const char *fragment_shader_src, const std::string &defines = "");
     Shader(const char *vertex_shader_src, const char *fragment_shader_src);
-    void createProgram();
+    // loads the linked binary from the cache when it is still valid, compiles, links and stores it otherwise
+    void createProgram(ShaderCache *cache = nullptr, const std::string &cacheName = "");
+
+    // createProgram in two halves, see ShaderCompiler. submit hands the sources to the driver
+    // without waiting on it, finish waits, reports errors and reflects the program
+    void submit(ShaderCache *cache = nullptr, const std::string &cacheName = "");
+    void finish();
+    // never blocks, true when finish() will not wait. Always true without parallel shader compile
+    bool isLinkDone() const;
     void use();
 
     void setUniforms(const char *uName, unsigned int type, void *value);
 
+    // cached by createProgram, -1 if the uniform is not active. Resolve once and keep the location
+    int getUniformLocation(const std::string &name) const { return uniforms.getLocation(name); }
+    const UniformCache &getUniforms() const { return uniforms; }
+
+    // typed setters on a resolved location, the program must be in use. -1 is ignored like in GL
+    void setInt(int location, int value);
+    void setBool(int location, bool value);
+    void setFloat(int location, float value);
+    void setVec2(int location, const glm::vec2 &value);
+    void setVec3(int location, const glm::vec3 &value);
+    void setVec4(int location, const glm::vec4 &value);
+    void setMat3(int location, const glm::mat3 &value);
+    void setMat4(int location, const glm::mat4 &value);
+
+    // whole arrays in one call, location is the one of element 0
+    void setVec3Array(int location, const glm::vec3 *values, int count);
+    void setMat4Array(int location, const glm::mat4 *values, int count);
+
 private:
+    UniformCache uniforms;
+    std::string vertexSource, fragmentSource, defines;
+
+    ShaderCache *cache = nullptr;
+    std::string cacheName;
+    uint64_t cacheKey = 0;
+
+    void readSources(const char *vertex_path, const char *fragment_path);
+    void insertDefines(std::string &source) const;
+    void compile();
+
     void checkCompileErrors(unsigned int id, const char *type);
+    void reflectUniforms();
+    void bindUniformBlocks();
 };
\ No newline at end of file
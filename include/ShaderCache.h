@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+// Linked program binaries on disk, one file per program name:
+//
+//   ShaderCacheHeader
+//   driver binary[length]
+//
+// The key hashes the GLSL sources, the defines and the driver (vendor, renderer,
+// version string), so an edited .glsl or a driver update simply misses and the
+// fresh binary overwrites the stale file. A binary the driver refuses also
+// counts as a miss. Does nothing without GLExtensions::programBinary.
+class ShaderCache
+{
+public:
+    explicit ShaderCache(const std::string &directory = "cache/shaders");
+
+    uint64_t key(const std::string &vertexSource, const std::string &fragmentSource, const std::string &defines = "");
+
+    // a linked program from the cached binary, 0 on a miss
+    unsigned int load(const std::string &name, uint64_t key);
+    // the program must have been linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT, see prepare()
+    void store(const std::string &name, uint64_t key, unsigned int program);
+    // call between glCreateProgram and glLinkProgram of a program that will be stored
+    void prepare(unsigned int program);
+
+    bool isEnabled() const;
+
+private:
+    std::string directory;
+    std::string driver; // read on first use, needs the context
+
+    std::string pathOf(const std::string &name) const;
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <deque>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "Shader.h"
+
+class ShaderCache;
+
+enum class CompileMode
+{
+    Blocking, // everything on the main thread, as soon as it is submitted
+    Parallel, // KHR_parallel_shader_compile, the driver compiles on its own threads
+    Worker,   // one thread with a hidden window sharing the main context
+};
+
+// Gets programs built without stalling the main thread. Submit() only hands the
+// sources over, Poll() tells without blocking whether a program is usable and
+// Wait() blocks until it is.
+//
+// With KHR_parallel_shader_compile the main thread submits and the driver works
+// in the background; completion is polled with GL_COMPLETION_STATUS_KHR. Without
+// it a worker thread builds whole programs on a shared context, the main thread
+// only sees them once the worker has finished them. If no shared context can be
+// made everything is built on submit.
+//
+// Shaders must stay at the same address until they are ready, and the main
+// thread must not touch a shader between Submit() and a Poll()/Wait() that
+// reports it ready.
+class ShaderCompiler
+{
+public:
+    ShaderCompiler() = default;
+    ~ShaderCompiler();
+
+    ShaderCompiler(const ShaderCompiler &) = delete;
+    ShaderCompiler &operator=(const ShaderCompiler &) = delete;
+
+    // picks the mode, call with the main context current
+    void Init();
+    // stops the worker and destroys its context, call before glfwTerminate
+    void Shutdown();
+
+    void Submit(Shader &shader, ShaderCache *cache, const std::string &name);
+    bool Poll(Shader &shader);
+    void Wait(Shader &shader);
+
+    CompileMode getMode() const { return mode; }
+    const char *getModeName() const;
+
+private:
+    CompileMode mode = CompileMode::Blocking;
+
+    GLFWwindow *workerContext = nullptr;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable jobFinished;
+
+    struct Job
+    {
+        Shader *shader;
+        ShaderCache *cache;
+        std::string name;
+    };
+    std::deque<Job> queue;
+    // submitted to the worker and not yet reported ready, finished is the done part of it
+    std::unordered_set<Shader *> inFlight;
+    std::unordered_set<Shader *> finished;
+    bool stopping = false;
+
+    void workerLoop();
+};
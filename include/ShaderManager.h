@@ -2,8 +2,15 @@
 
 // #include <vector>
 #include <map>
+#include <vector>
+#include <chrono>
 
 #include "Shader.h"
+#include "ShaderCache.h"
+#include "ShaderCompiler.h"
+
+// drawn in place of model variants that are still compiling, see SceneManager::RenderModels
+constexpr const char *FALLBACK_SHADER = "fallback";
 
 class ShaderManager
 {
@@ -13,13 +20,40 @@ public:
 
     ShaderManager();
 
+    // stops the compile thread, call before glfwTerminate
+    void Shutdown();
+
+    // submitted to the ShaderCompiler right away, findShader is the first use and waits for it
     void addShader(const std::string &shaderName, const char *vertex_shader_src, const char *fragment_shader_src);
 
+    // a base program with one variant per combination of the given ShaderFeature bits, all
+    // submitted up front. A variant is listed as "name+SKINNED+TEXTURED"
+    void addShaderVariants(const std::string &shaderName, const char *vertex_shader_src, const char *fragment_shader_src, uint32_t features);
+
+    // the variant with these features, bits the base was not registered with are dropped.
+    // waits for it to finish compiling
+    Shader &findVariant(const std::string &shaderName, uint32_t features);
+    // same, but nullptr while it is still compiling
+    Shader *findVariantIfReady(const std::string &shaderName, uint32_t features);
+
     bool deleteShader(const char *shaderName);
 
     Shader &findShader(const std::string &shaderName);
 
-    // void Update();
+    // picks up programs that finished compiling, call once per frame
+    void Update();
+
+    size_t compilingCount() const { return pending.size(); }
+    const char *getCompileModeName() const { return compiler.getModeName(); }
+
+    // cache hits and misses of the finished programs and the main thread time spent on shaders so far
+    void printStats() const
+    {
+        std::cout << "[ShaderManager] " << shaderMap.size() << " programs, " << pending.size() << " still compiling, "
+                  << mainThreadMilliseconds << " ms on the main thread, "
+                  << cacheHits << " cache hits, " << cacheMisses << " misses"
+                  << (cache.isEnabled() ? "" : " (no program binary support)") << std::endl;
+    }
 
     void listShaders()
     {
@@ -33,4 +67,28 @@ public:
 private:
     std::map<std::string, Shader> shaderMap;
     unsigned int shaderCount = 0;
+
+    struct VariantSet
+    {
+        std::string vertexPath, fragmentPath;
+        uint32_t features = 0;
+        Shader *variants[1 << SHADER_FEATURE_COUNT] = {}; // by feature mask, null until built
+    };
+    std::map<std::string, VariantSet> variantSets;
+
+    ShaderCache cache;
+    ShaderCompiler compiler;
+    // submitted and not yet reported ready by the compiler
+    std::vector<Shader *> pending;
+    std::chrono::high_resolution_clock::time_point firstSubmit;
+    unsigned int cacheHits = 0, cacheMisses = 0;
+    double mainThreadMilliseconds = 0.0;
+
+    Shader &build(const std::string &shaderName, const char *vertex_path, const char *fragment_path, const std::string &defines);
+    Shader &buildVariant(const std::string &shaderName, VariantSet &set, uint32_t features);
+    VariantSet &findVariantSet(const std::string &shaderName);
+
+    bool poll(Shader &shader);
+    void wait(Shader &shader);
+    void completed(Shader &shader);
 };
\ No newline at end of file
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+// Generational handle into a SlotMap. A handle stays valid until the element it
+// refers to is erased; after that the generation no longer matches and lookups
+// fail instead of silently returning whatever reused the slot.
+struct SlotHandle
+{
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+    uint32_t index = INVALID_INDEX;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != INVALID_INDEX; }
+
+    bool operator==(const SlotHandle &other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const SlotHandle &other) const { return !(*this == other); }
+};
+
+// O(1) insert / lookup / erase container with densely packed storage.
+// Elements live contiguously so iteration is a linear walk; erase swaps the last
+// element into the hole, so raw pointers/references may move but handles do not.
+template <typename T>
+class SlotMap
+{
+public:
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    SlotHandle insert(T value)
+    {
+        return emplace(std::move(value));
+    }
+
+    template <typename... Args>
+    SlotHandle emplace(Args &&...args)
+    {
+        uint32_t slotIndex;
+        if (!freeSlots.empty())
+        {
+            slotIndex = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            slotIndex = static_cast<uint32_t>(slots.size());
+            slots.push_back({0, 0});
+        }
+
+        Slot &slot = slots[slotIndex];
+        slot.denseIndex = static_cast<uint32_t>(dense.size());
+
+        dense.emplace_back(std::forward<Args>(args)...);
+        denseToSlot.push_back(slotIndex);
+
+        return {slotIndex, slot.generation};
+    }
+
+    T *get(SlotHandle handle)
+    {
+        if (!contains(handle))
+            return nullptr;
+        return &dense[slots[handle.index].denseIndex];
+    }
+
+    const T *get(SlotHandle handle) const
+    {
+        if (!contains(handle))
+            return nullptr;
+        return &dense[slots[handle.index].denseIndex];
+    }
+
+    bool contains(SlotHandle handle) const
+    {
+        return handle.index < slots.size() && slots[handle.index].generation == handle.generation &&
+               slots[handle.index].denseIndex != SlotHandle::INVALID_INDEX;
+    }
+
+    bool erase(SlotHandle handle)
+    {
+        if (!contains(handle))
+            return false;
+
+        Slot &slot = slots[handle.index];
+        uint32_t hole = slot.denseIndex;
+        uint32_t last = static_cast<uint32_t>(dense.size() - 1);
+
+        if (hole != last)
+        {
+            dense[hole] = std::move(dense[last]);
+            denseToSlot[hole] = denseToSlot[last];
+            slots[denseToSlot[hole]].denseIndex = hole;
+        }
+
+        dense.pop_back();
+        denseToSlot.pop_back();
+
+        // bumping the generation is what invalidates every outstanding handle to this slot
+        slot.denseIndex = SlotHandle::INVALID_INDEX;
+        slot.generation++;
+        freeSlots.push_back(handle.index);
+        return true;
+    }
+
+    void clear()
+    {
+        for (uint32_t slotIndex : denseToSlot)
+        {
+            slots[slotIndex].denseIndex = SlotHandle::INVALID_INDEX;
+            slots[slotIndex].generation++;
+            freeSlots.push_back(slotIndex);
+        }
+        dense.clear();
+        denseToSlot.clear();
+    }
+
+    void reserve(size_t count)
+    {
+        dense.reserve(count);
+        denseToSlot.reserve(count);
+        slots.reserve(count);
+    }
+
+    // handle of the element currently stored at a dense position (for iteration)
+    SlotHandle handleAt(size_t denseIndex) const
+    {
+        uint32_t slotIndex = denseToSlot[denseIndex];
+        return {slotIndex, slots[slotIndex].generation};
+    }
+
+    T &operator[](size_t denseIndex) { return dense[denseIndex]; }
+    const T &operator[](size_t denseIndex) const { return dense[denseIndex]; }
+
+    size_t size() const { return dense.size(); }
+    bool empty() const { return dense.empty(); }
+
+    iterator begin() { return dense.begin(); }
+    iterator end() { return dense.end(); }
+    const_iterator begin() const { return dense.begin(); }
+    const_iterator end() const { return dense.end(); }
+
+private:
+    struct Slot
+    {
+        uint32_t denseIndex;
+        uint32_t generation;
+    };
+
+    std::vector<T> dense;
+    std::vector<uint32_t> denseToSlot;
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+};
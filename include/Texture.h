@@ -7,6 +7,13 @@
 
 #include "Shader.h"
 
+// decoded pixels waiting for upload, produced off the main thread
+struct TextureImage
+{
+    int width = 0, height = 0, channels = 0;
+    unsigned char *pixels = nullptr;
+};
+
 class Texture
 {
 public:
@@ -17,6 +24,15 @@ public:
     std::string type;
 
     Texture(const char *filePath, GLenum textureType, unsigned int textureUnit, const std::string &typeName);
+    // uploads an already decoded image, pixels stay owned by the caller
+    Texture(const std::string &filePath, const TextureImage &image, GLenum textureType, unsigned int textureUnit, const std::string &typeName);
+
+    // same GL texture, bound under another sampler type and unit
+    Texture withBinding(unsigned int textureUnit, const std::string &typeName) const;
+
+    // stb decode only, no GL, safe on worker threads
+    static bool Decode(const std::string &filePath, TextureImage &image);
+    static void FreeImage(TextureImage &image);
     void Bind(unsigned int texSlot);
     void SetUniform(Shader &shader, const std::string &uniformName);
     void UnBind();
@@ -24,4 +40,6 @@ public:
 private:
     GLenum textureType;
     unsigned int textureUnit;
+
+    void Upload(const TextureImage &image);
 };
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+// per-frame counters of the last update()
+struct TransformStats
+{
+    unsigned int recomputed = 0;
+    unsigned int skipped = 0;
+};
+
+// Structure-of-arrays transform component for every scene node.
+// Local TRS and the cached world matrix are stored in parallel arrays kept in
+// breadth-first order, so parents always precede their children and update()
+// resolves the whole hierarchy in a single linear pass.
+// Only nodes whose local transform changed, or whose parent's world changed,
+// are recomputed; everything else keeps last frame's matrices.
+class TransformStore
+{
+public:
+    static constexpr uint32_t NONE = 0xFFFFFFFF;
+
+    // parentID = NONE for a root
+    void add(unsigned int nodeID, unsigned int parentID);
+    void remove(unsigned int nodeID);
+    void setParent(unsigned int nodeID, unsigned int parentID);
+    void clear();
+
+    bool contains(unsigned int nodeID) const;
+    size_t size() const { return nodeIDs.size(); }
+
+    // local space, rotation is XYZ euler in radians
+    void setPosition(unsigned int nodeID, const glm::vec3 &position);
+    void setRotation(unsigned int nodeID, const glm::vec3 &rotation);
+    void setScale(unsigned int nodeID, const glm::vec3 &scale);
+
+    glm::vec3 getPosition(unsigned int nodeID) const;
+    glm::vec3 getRotation(unsigned int nodeID) const;
+    glm::vec3 getScale(unsigned int nodeID) const;
+
+    // world space, valid after update()
+    const glm::mat4 &getWorldMatrix(unsigned int nodeID) const;
+    const glm::mat3 &getNormalMatrix(unsigned int nodeID) const;
+    glm::vec3 getWorldPosition(unsigned int nodeID) const;
+
+    // true if the node's world matrix was recomputed by the last update()
+    bool wasUpdated(unsigned int nodeID) const;
+    const TransformStats &getStats() const { return stats; }
+
+    // writes a world matrix back as the node's local translation and rotation (used by physics), scale is kept
+    void setWorldMatrix(unsigned int nodeID, const glm::mat4 &world);
+
+    void update();
+
+private:
+    std::vector<unsigned int> nodeIDs;
+    std::vector<uint32_t> parents; // index into these arrays, NONE for roots
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> rotations;
+    std::vector<glm::vec3> scales;
+    std::vector<glm::mat4> worldMatrices;
+    std::vector<glm::mat3> normalMatrices;
+    std::vector<uint8_t> localDirty;   // local TRS edited since the last update
+    std::vector<uint8_t> worldChanged; // world recomputed in the last update
+
+    std::vector<uint32_t> indexByNode; // node ID -> array index
+    TransformStats stats;
+
+    // set when removal or reparenting may have broken the parent-before-child order
+    bool needsFlatten = false;
+
+    uint32_t indexOf(unsigned int nodeID) const;
+    void flatten();
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// CPU mirrors of the std140 uniform blocks shared by every shader. Keep them in
+// sync with the block declarations in shaders/: std140 pads vec3 to 16 bytes,
+// so positions and colors are vec4 and scalars sit in a full 16 byte slot.
+
+constexpr unsigned int FRAME_DATA_BINDING = 0;
+constexpr unsigned int LIGHT_DATA_BINDING = 1;
+
+// layout(std140) uniform FrameData
+struct FrameData
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec4 camPos; // w unused
+};
+
+// layout(std140) uniform LightData, the lights themselves are in texture buffers, see LightClusters.h
+struct LightData
+{
+    glm::ivec4 clusterGrid;  // tiles x, tiles y, depth slices, global light count
+    glm::vec4 clusterDepth;  // slice = log(view depth) * x + y, zw unused
+    glm::ivec4 texelBase;    // first texel of the light data, cluster ranges and light indices, w light count
+};
+
+static_assert(sizeof(FrameData) == 144, "FrameData no longer matches its std140 block");
+static_assert(sizeof(LightData) == 48, "LightData no longer matches its std140 block");
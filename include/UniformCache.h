@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+struct UniformInfo
+{
+    int location = -1;
+    unsigned int type = 0; // GL type enum, GL_FLOAT_MAT4 etc.
+    int size = 1;          // array length, 1 for plain uniforms
+};
+
+// Name -> location table of a linked program's active uniforms, filled once by
+// Shader after linking so nothing asks the driver for locations at draw time.
+// Arrays are stored under their base name ("bone_transforms") and under every
+// element name ("bone_transforms[3]").
+class UniformCache
+{
+public:
+    void add(const std::string &name, const UniformInfo &info) { uniforms[name] = info; }
+    void clear() { uniforms.clear(); }
+
+    // nullptr if the uniform is not active in the program
+    const UniformInfo *find(const std::string &name) const
+    {
+        auto it = uniforms.find(name);
+        return it != uniforms.end() ? &it->second : nullptr;
+    }
+
+    int getLocation(const std::string &name) const
+    {
+        const UniformInfo *info = find(name);
+        return info ? info->location : -1;
+    }
+
+    size_t size() const { return uniforms.size(); }
+
+private:
+    std::unordered_map<std::string, UniformInfo> uniforms;
+};
@@ -8,13 +8,20 @@
 class Window
 {
 public:
-    const GLFWvidmode *mode;
+    // primary monitor's, nullptr when headless
+    const GLFWvidmode *mode = nullptr;
 
     Window(const char *title);
+    // headless: nothing is shown, the context comes from EGL (surfaceless) or
+    // OSMesa and draws into an OffscreenTarget. glfwInit() must have been hinted
+    // to the null platform so no display is needed
+    Window(const char *title, int width, int height);
+    // nullptr if the window could not be created
     GLFWwindow *getWindowObject();
 
 private:
-    GLFWwindow *window;
+    GLFWwindow *window = nullptr;
 
+    bool loadGL();
     void setViewport();
 };
\ No newline at end of file
@@ -0,0 +1,33 @@
+#version 330 core
+// G-buffer fill of the deferred path, drawn with shaders/model/vertex.glsl, see GBuffer.h
+// variants: TEXTURED, see ShaderFeature in Shader.h
+layout (location = 0) out vec4 AlbedoSpecular; // rgb albedo, a specular strength
+layout (location = 1) out vec2 EncodedNormal;  // octahedral, remapped to 0..1
+
+#ifdef TEXTURED
+uniform sampler2D texture_diffuse0;
+#endif
+
+in vec3 Normal;
+in vec2 TexCoord;
+
+// folds the lower hemisphere of the octahedron over the upper one
+vec2 octWrap(vec2 v) {
+    return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0);
+}
+
+vec2 encodeNormal(vec3 n) {
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 e = n.z >= 0.0 ? n.xy : octWrap(n.xy);
+    return e * 0.5 + 0.5;
+}
+
+void main() {
+    // same constant specular strength as the forward path
+#ifdef TEXTURED
+    AlbedoSpecular = vec4(texture(texture_diffuse0, TexCoord).rgb, 0.5);
+#else
+    AlbedoSpecular = vec4(1.0, 1.0, 1.0, 0.5);
+#endif
+    EncodedNormal = encodeNormal(normalize(Normal));
+}
@@ -0,0 +1,102 @@
+#version 330 core
+// lighting pass of the deferred path, one fragment per G-buffer pixel
+// variants: CLUSTERED_LIGHTS, see ShaderFeature in Shader.h
+out vec4 FragColor;
+
+layout (std140) uniform FrameData // binding 0, see UniformBlocks.h
+{
+    mat4 view;
+    mat4 projection;
+    vec4 camPos;
+};
+
+layout (std140) uniform LightData // binding 1, lists built by LightClusters
+{
+    ivec4 clusterGrid;  // tiles x, tiles y, depth slices, global light count
+    vec4 clusterDepth;  // slice = log(view depth) * x + y
+    ivec4 texelBase;    // first texel of lightData, clusterRanges, lightIndices; w light count
+};
+
+uniform samplerBuffer lightData;      // 2 texels per light: position + radius, color
+#ifdef CLUSTERED_LIGHTS
+uniform usamplerBuffer clusterRanges; // per cluster: first entry in lightIndices, count
+uniform usamplerBuffer lightIndices;
+#endif
+
+uniform sampler2D gAlbedoSpecular;
+uniform sampler2D gNormal;
+uniform sampler2D gDepth;
+
+uniform mat4 inverseViewProjection;
+
+vec3 decodeNormal(vec2 e) {
+    e = e * 2.0 - 1.0;
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
+// keep in sync with shadeLight in shaders/model/fragment.glsl
+vec3 shadeLight(int light, vec3 fragPos, vec3 norm, vec3 viewDir, float specularStrength, bool bounded) {
+    vec4 positionRadius = texelFetch(lightData, texelBase.x + light * 2);
+    vec3 lightColor = texelFetch(lightData, texelBase.x + light * 2 + 1).rgb;
+
+    float attenuation = 1.0;
+    if (bounded) {
+        float d = length(positionRadius.xyz - fragPos) / positionRadius.w;
+        float window = clamp(1.0 - d * d * d * d, 0.0, 1.0);
+        attenuation = window * window;
+    }
+
+    vec3 ambient = 0.1 * lightColor;
+
+    vec3 lightDir = normalize(positionRadius.xyz - fragPos);
+    vec3 diffuse = max(dot(norm, lightDir), 0.0) * lightColor;
+
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
+    vec3 specular = specularStrength * spec * lightColor;
+
+    return (ambient + diffuse + specular) * attenuation;
+}
+
+void main() {
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    float depth = texelFetch(gDepth, pixel, 0).r;
+    // nothing was drawn here, the clear color stays
+    if (depth == 1.0)
+        discard;
+
+    vec3 ndc = vec3(gl_FragCoord.xy / vec2(textureSize(gDepth, 0)), depth) * 2.0 - 1.0;
+    vec4 world = inverseViewProjection * vec4(ndc, 1.0);
+    vec3 fragPos = world.xyz / world.w;
+    // clip w (view depth) straight from the projection, for the cluster slice
+    float viewDepth = projection[3][2] / (ndc.z + projection[2][2]);
+
+    vec4 albedoSpecular = texelFetch(gAlbedoSpecular, pixel, 0);
+    vec3 norm = decodeNormal(texelFetch(gNormal, pixel, 0).xy);
+    vec3 viewDir = normalize(camPos.xyz - fragPos);
+
+    vec3 result = vec3(0.0);
+    for (int i = 0; i < clusterGrid.w; ++i)
+        result += shadeLight(i, fragPos, norm, viewDir, albedoSpecular.a, false);
+
+#ifdef CLUSTERED_LIGHTS
+    if (clusterGrid.z > 0) {
+        ivec3 cluster = ivec3(clamp(ivec2((ndc.xy * 0.5 + 0.5) * vec2(clusterGrid.xy)), ivec2(0), clusterGrid.xy - 1),
+                              clamp(int(log(viewDepth) * clusterDepth.x + clusterDepth.y), 0, clusterGrid.z - 1));
+        int clusterIndex = (cluster.z * clusterGrid.y + cluster.y) * clusterGrid.x + cluster.x;
+        uvec2 range = texelFetch(clusterRanges, texelBase.y + clusterIndex).xy;
+
+        for (uint i = 0u; i < range.y; ++i) {
+            int light = int(texelFetch(lightIndices, texelBase.z + int(range.x + i)).r);
+            result += shadeLight(light, fragPos, norm, viewDir, albedoSpecular.a, true);
+        }
+    }
+#endif
+
+    FragColor = vec4(result * albedoSpecular.rgb, 1.0);
+    // later forward passes (gizmos, particles) depth test against the scene
+    gl_FragDepth = depth;
+}
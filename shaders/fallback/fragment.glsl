@@ -0,0 +1,20 @@
+#version 330 core
+// flat grey with a fixed key light, skinned meshes show their bind pose until their variant is in
+layout (location = 0) out vec4 FragColor;
+// only written when drawing into the G-buffer, same encoding as shaders/deferred/gbuffer.frag
+layout (location = 1) out vec2 EncodedNormal;
+
+in vec3 Normal;
+
+vec2 encodeNormal(vec3 n) {
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    vec2 e = n.z >= 0.0 ? n.xy : (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+    return e * 0.5 + 0.5;
+}
+
+void main() {
+    vec3 norm = normalize(Normal);
+    float light = 0.35 + 0.4 * max(dot(norm, normalize(vec3(0.4, 1.0, 0.3))), 0.0);
+    FragColor = vec4(vec3(light), 0.5);
+    EncodedNormal = encodeNormal(norm);
+}
@@ -0,0 +1,23 @@
+#version 330 core
+// stands in for model variants that are still compiling, kept tiny so it is ready first
+
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+
+// per instance, see InstanceData in RenderQueue.h
+layout (location = 5) in mat4 instanceModel;
+layout (location = 9) in mat3 instanceNormalMatrix;
+
+layout (std140) uniform FrameData // binding 0, see UniformBlocks.h
+{
+    mat4 view;
+    mat4 projection;
+    vec4 camPos;
+};
+
+out vec3 Normal;
+
+void main() {
+    gl_Position = projection * view * instanceModel * vec4(aPos, 1.0);
+    Normal = instanceNormalMatrix * aNormal;
+}
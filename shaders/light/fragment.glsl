@@ -1,8 +1,8 @@
 #version 330 core
 out vec4 FragColor;
 
-uniform vec3 uLightColor;
+in vec3 LightColor;
 
 void main(){
-    FragColor  = vec4(uLightColor, 1.f);
+    FragColor  = vec4(LightColor, 1.f);
 }
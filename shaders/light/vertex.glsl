@@ -3,14 +3,22 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
 
-uniform mat4 projection;
-uniform mat4 view;
-uniform mat4 model;
-uniform vec3 uLightPos;
+// per instance, see InstanceData in RenderQueue.h
+layout (location = 5) in mat4 instanceModel;
+layout (location = 12) in vec4 instanceColor;
+
+layout (std140) uniform FrameData // binding 0, see UniformBlocks.h
+{
+    mat4 view;
+    mat4 projection;
+    vec4 camPos;
+};
 
 out vec2 TexCoord;
+out vec3 LightColor;
 
 void main(){
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    gl_Position = projection * view * instanceModel * vec4(aPos, 1.0);
     TexCoord = aTexCoord;
+    LightColor = instanceColor.rgb;
 }
\ No newline at end of file
@@ -1,46 +1,95 @@
 #version 330 core
+// variants: TEXTURED, CLUSTERED_LIGHTS, see ShaderFeature in Shader.h
 out vec4 FragColor;
 
-uniform vec3 uCamPos;
+layout (std140) uniform FrameData // binding 0, see UniformBlocks.h
+{
+    mat4 view;
+    mat4 projection;
+    vec4 camPos;
+};
 
-uniform int numLights;  // pass number of active lights
-uniform vec3 lightPositions[16];  // max 16 lights
-uniform vec3 lightColors[16];
+layout (std140) uniform LightData // binding 1, lists built by LightClusters
+{
+    ivec4 clusterGrid;  // tiles x, tiles y, depth slices, global light count
+    vec4 clusterDepth;  // slice = log(view depth) * x + y
+    ivec4 texelBase;    // first texel of lightData, clusterRanges, lightIndices; w light count
+};
 
+uniform samplerBuffer lightData;      // 2 texels per light: position + radius, color
+#ifdef CLUSTERED_LIGHTS
+uniform usamplerBuffer clusterRanges; // per cluster: first entry in lightIndices, count
+uniform usamplerBuffer lightIndices;
+#endif
+
+#ifdef TEXTURED
 uniform sampler2D texture_diffuse0;
-uniform sampler2D texture_specular0;
+#endif
 
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoord;
+in vec4 ClipPos;
+
+// keep in sync with shadeLight in shaders/deferred/lighting.frag
+vec3 shadeLight(int light, vec3 norm, vec3 viewDir, bool bounded) {
+    vec4 positionRadius = texelFetch(lightData, texelBase.x + light * 2);
+    vec3 lightColor = texelFetch(lightData, texelBase.x + light * 2 + 1).rgb;
+
+    // windowed falloff, reaches zero at the radius the light was clustered with
+    float attenuation = 1.0;
+    if (bounded) {
+        float d = length(positionRadius.xyz - FragPos) / positionRadius.w;
+        float window = clamp(1.0 - d * d * d * d, 0.0, 1.0);
+        attenuation = window * window;
+    }
+
+    // Ambient
+    float ambientStrength = 0.1;
+    vec3 ambient = ambientStrength * lightColor;
+
+    // Diffuse
+    vec3 lightDir = normalize(positionRadius.xyz - FragPos);
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = diff * lightColor;
+
+    // Specular
+    float specularStrength = 0.5;
+    vec3 reflectDir = reflect(-lightDir, norm);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
+    vec3 specular = specularStrength * spec * lightColor;
+
+    return (ambient + diffuse + specular) * attenuation;
+}
 
 void main() {
     vec3 result = vec3(0.0);
     vec3 norm = normalize(Normal);
-    vec3 viewDir = normalize(uCamPos - FragPos);
+    vec3 viewDir = normalize(camPos.xyz - FragPos);
 
-    for (int i = 0; i < numLights; ++i) {
-        // Ambient
-        float ambientStrength = 0.1;
-        vec3 ambient = ambientStrength * lightColors[i];
+    for (int i = 0; i < clusterGrid.w; ++i)
+        result += shadeLight(i, norm, viewDir, false);
 
-        // Diffuse
-        vec3 lightDir = normalize(lightPositions[i] - FragPos);
-        float diff = max(dot(norm, lightDir), 0.0);
-        vec3 diffuse = diff * lightColors[i];
+#ifdef CLUSTERED_LIGHTS
+    // only the lights whose sphere touches this fragment's cluster
+    if (clusterGrid.z > 0) {
+        vec2 ndc = ClipPos.xy / ClipPos.w;
+        ivec3 cluster = ivec3(clamp(ivec2((ndc * 0.5 + 0.5) * vec2(clusterGrid.xy)), ivec2(0), clusterGrid.xy - 1),
+                              clamp(int(log(ClipPos.w) * clusterDepth.x + clusterDepth.y), 0, clusterGrid.z - 1));
+        int clusterIndex = (cluster.z * clusterGrid.y + cluster.y) * clusterGrid.x + cluster.x;
+        uvec2 range = texelFetch(clusterRanges, texelBase.y + clusterIndex).xy;
 
-        // Specular
-        float specularStrength = 0.5;
-        vec3 reflectDir = reflect(-lightDir, norm);
-        float spec = pow(max(dot(viewDir, reflectDir), 0.0), 32);
-        vec3 specular = specularStrength * spec * lightColors[i];
-
-        result += (ambient + diffuse + specular);
+        for (uint i = 0u; i < range.y; ++i) {
+            int light = int(texelFetch(lightIndices, texelBase.z + int(range.x + i)).r);
+            result += shadeLight(light, norm, viewDir, true);
+        }
     }
+#endif
 
+#ifdef TEXTURED
     vec4 texColor = texture(texture_diffuse0, TexCoord);
+#else
+    vec4 texColor = vec4(1.0);
+#endif
     FragColor = vec4(result * texColor.rgb, texColor.a);
-    
-
-
 }
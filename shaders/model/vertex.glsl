@@ -1,38 +1,59 @@
 #version 330 core
+// variants: SKINNED, see ShaderFeature in Shader.h
 
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoord;
+
+// per instance, see InstanceData in RenderQueue.h
+layout (location = 5) in mat4 instanceModel;
+layout (location = 9) in mat3 instanceNormalMatrix; // transpose(inverse(mat3(model))), cached on the CPU
+
+layout (std140) uniform FrameData // binding 0, see UniformBlocks.h
+{
+    mat4 view;
+    mat4 projection;
+    vec4 camPos;
+};
+
+#ifdef SKINNED
 layout (location = 3) in ivec4 boneIds;
 layout (location = 4) in vec4 boneWeights;
+layout (location = 13) in int instanceBoneOffset; // first matrix in bonePalette
 
-uniform mat4 projection;
-uniform mat4 view;
-uniform mat4 model;
-uniform mat4 bone_transforms[200];
-uniform bool isAnimated;
+uniform samplerBuffer bonePalette; // every skinned model of the frame, 4 texels per matrix
+
+mat4 fetchBone(int id) {
+    int base = (instanceBoneOffset + id) * 4;
+    return mat4(texelFetch(bonePalette, base),
+                texelFetch(bonePalette, base + 1),
+                texelFetch(bonePalette, base + 2),
+                texelFetch(bonePalette, base + 3));
+}
+#endif
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
+out vec4 ClipPos; // picks the light cluster in the fragment shader
 
 void main(){
 
-mat4 skinningTransform = mat4(1.0);
-
-if (isAnimated) {
-    mat4 boneTransform = mat4(0.0);
-    boneTransform += bone_transforms[int(boneIds.x)] * boneWeights.x;
-    boneTransform += bone_transforms[int(boneIds.y)] * boneWeights.y;
-    boneTransform += bone_transforms[int(boneIds.z)] * boneWeights.z;
-    boneTransform += bone_transforms[int(boneIds.w)] * boneWeights.w;
-    skinningTransform = boneTransform;
-}
-
+#ifdef SKINNED
+mat4 skinningTransform = fetchBone(boneIds.x) * boneWeights.x
+                       + fetchBone(boneIds.y) * boneWeights.y
+                       + fetchBone(boneIds.z) * boneWeights.z
+                       + fetchBone(boneIds.w) * boneWeights.w;
 vec4 skinnedPos = skinningTransform * vec4(aPos, 1.0);
-
-gl_Position = projection * view * model * skinnedPos;
-FragPos = vec3(model * skinnedPos);
-Normal = mat3(transpose(inverse(model))) * mat3(skinningTransform) * aNormal;
+vec3 skinnedNormal = mat3(skinningTransform) * aNormal;
+#else
+vec4 skinnedPos = vec4(aPos, 1.0);
+vec3 skinnedNormal = aNormal;
+#endif
+
+gl_Position = projection * view * instanceModel * skinnedPos;
+ClipPos = gl_Position;
+FragPos = vec3(instanceModel * skinnedPos);
+Normal = instanceNormalMatrix * skinnedNormal;
 TexCoord = aTexCoord;
-}
\ No newline at end of file
+}
@@ -5,8 +5,12 @@ layout (location = 2) in vec4 aInstanceColor; // Per-instance color
 
 out vec4 vColor; // Pass the color to the fragment shader
 
-uniform mat4 view;
-uniform mat4 projection;
+layout (std140) uniform FrameData // binding 0, see UniformBlocks.h
+{
+    mat4 view;
+    mat4 projection;
+    vec4 camPos;
+};
 
 void main()
 {
@@ -0,0 +1,362 @@
+#include "AABBTree.h"
+
+#include <algorithm>
+#include <utility>
+
+using TreeMath::area;
+using TreeMath::merge;
+
+AABBTree::AABBTree(float margin) : margin(margin)
+{
+}
+
+uint32_t AABBTree::allocateNode()
+{
+    if (freeList == NONE)
+    {
+        nodes.emplace_back();
+        return static_cast<uint32_t>(nodes.size() - 1);
+    }
+
+    uint32_t index = freeList;
+    freeList = nodes[index].child2;
+    nodes[index] = TreeNode();
+    return index;
+}
+
+void AABBTree::freeNode(uint32_t index)
+{
+    nodes[index].height = -1;
+    nodes[index].child1 = NONE;
+    nodes[index].child2 = freeList;
+    freeList = index;
+}
+
+void AABBTree::clear()
+{
+    nodes.clear();
+    root = NONE;
+    freeList = NONE;
+    leafCount = 0;
+}
+
+uint32_t AABBTree::insert(const AABB &box, uint32_t item)
+{
+    uint32_t leaf = allocateNode();
+    nodes[leaf].box = {box.min - glm::vec3(margin), box.max + glm::vec3(margin)};
+    nodes[leaf].item = item;
+    nodes[leaf].height = 0;
+
+    insertLeaf(leaf);
+    leafCount++;
+    return leaf;
+}
+
+void AABBTree::remove(uint32_t proxy)
+{
+    removeLeaf(proxy);
+    freeNode(proxy);
+    leafCount--;
+}
+
+bool AABBTree::move(uint32_t proxy, const AABB &box, const glm::vec3 &displacement)
+{
+    const AABB &fat = nodes[proxy].box;
+    if (fat.min.x <= box.min.x && fat.min.y <= box.min.y && fat.min.z <= box.min.z &&
+        fat.max.x >= box.max.x && fat.max.y >= box.max.y && fat.max.z >= box.max.z)
+        return false;
+
+    // stretched ahead along the motion, a steadily moving object then stays inside for several frames
+    AABB fatBox = {box.min - glm::vec3(margin), box.max + glm::vec3(margin)};
+    glm::vec3 ahead = displacement * DISPLACEMENT_MULTIPLIER;
+    fatBox.min += glm::min(ahead, glm::vec3(0.0f));
+    fatBox.max += glm::max(ahead, glm::vec3(0.0f));
+
+    removeLeaf(proxy);
+    nodes[proxy].box = fatBox;
+    insertLeaf(proxy);
+    return true;
+}
+
+uint32_t AABBTree::findBestSibling(const AABB &box) const
+{
+    // cost of a sibling = area of the new parent + growth of every ancestor above it.
+    // a subtree can be skipped once even a perfect fit below it would lose to the best so far
+    const float boxArea = area(box);
+
+    uint32_t best = root;
+    float bestCost = area(merge(nodes[root].box, box));
+
+    candidates.clear();
+    candidates.emplace_back(root, 0.0f);
+    while (!candidates.empty())
+    {
+        auto [index, inherited] = candidates.back();
+        candidates.pop_back();
+
+        const TreeNode &node = nodes[index];
+        float directCost = area(merge(node.box, box));
+        float cost = directCost + inherited;
+        if (cost < bestCost)
+        {
+            bestCost = cost;
+            best = index;
+        }
+
+        if (node.isLeaf())
+            continue;
+
+        float childInherited = inherited + directCost - area(node.box);
+        if (boxArea + childInherited < bestCost)
+        {
+            // the more promising child goes on top, a good early best prunes most of the rest
+            uint32_t first = node.child1, second = node.child2;
+            if (area(merge(nodes[second].box, box)) - area(nodes[second].box) <
+                area(merge(nodes[first].box, box)) - area(nodes[first].box))
+                std::swap(first, second);
+            candidates.emplace_back(second, childInherited);
+            candidates.emplace_back(first, childInherited);
+        }
+    }
+    return best;
+}
+
+void AABBTree::insertLeaf(uint32_t leaf)
+{
+    if (root == NONE)
+    {
+        root = leaf;
+        nodes[leaf].parent = NONE;
+        return;
+    }
+
+    uint32_t sibling = findBestSibling(nodes[leaf].box);
+
+    uint32_t oldParent = nodes[sibling].parent;
+    uint32_t newParent = allocateNode();
+    nodes[newParent].parent = oldParent;
+    nodes[newParent].box = merge(nodes[sibling].box, nodes[leaf].box);
+    nodes[newParent].height = nodes[sibling].height + 1;
+    nodes[newParent].child1 = sibling;
+    nodes[newParent].child2 = leaf;
+    nodes[sibling].parent = newParent;
+    nodes[leaf].parent = newParent;
+
+    if (oldParent == NONE)
+        root = newParent;
+    else if (nodes[oldParent].child1 == sibling)
+        nodes[oldParent].child1 = newParent;
+    else
+        nodes[oldParent].child2 = newParent;
+
+    refitFrom(oldParent);
+}
+
+void AABBTree::removeLeaf(uint32_t leaf)
+{
+    if (leaf == root)
+    {
+        root = NONE;
+        return;
+    }
+
+    // the sibling takes the parent's place
+    uint32_t parent = nodes[leaf].parent;
+    uint32_t grandParent = nodes[parent].parent;
+    uint32_t sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+    nodes[sibling].parent = grandParent;
+    if (grandParent == NONE)
+        root = sibling;
+    else if (nodes[grandParent].child1 == parent)
+        nodes[grandParent].child1 = sibling;
+    else
+        nodes[grandParent].child2 = sibling;
+
+    freeNode(parent);
+    refitFrom(grandParent);
+}
+
+void AABBTree::refitFrom(uint32_t index)
+{
+    while (index != NONE)
+    {
+        TreeNode &node = nodes[index];
+        AABB box = merge(nodes[node.child1].box, nodes[node.child2].box);
+        int height = 1 + std::max(nodes[node.child1].height, nodes[node.child2].height);
+
+        // nothing above can change once a node comes out the same, stopping here
+        // keeps a reinsert local instead of walking and rotating up to the root
+        if (box.min == node.box.min && box.max == node.box.max && height == node.height)
+            return;
+        node.box = box;
+        node.height = height;
+
+        rotate(index);
+        index = nodes[index].parent;
+    }
+}
+
+void AABBTree::rotate(uint32_t index)
+{
+    // swap one child with a grandchild on the other side when that shrinks the
+    // other child's box, the box of index itself stays the same either way
+    TreeNode &a = nodes[index];
+    if (a.height < 2)
+        return;
+
+    uint32_t b = a.child1, c = a.child2;
+
+    enum Rotation
+    {
+        NO_ROTATION,
+        B_F,
+        B_G,
+        C_D,
+        C_E
+    };
+    Rotation rotation = NO_ROTATION;
+    float bestDelta = 0.0f;
+
+    if (!nodes[c].isLeaf())
+    {
+        float areaC = area(nodes[c].box);
+        uint32_t f = nodes[c].child1, g = nodes[c].child2;
+
+        float delta = area(merge(nodes[b].box, nodes[g].box)) - areaC;
+        if (delta < bestDelta)
+        {
+            rotation = B_F;
+            bestDelta = delta;
+        }
+        delta = area(merge(nodes[b].box, nodes[f].box)) - areaC;
+        if (delta < bestDelta)
+        {
+            rotation = B_G;
+            bestDelta = delta;
+        }
+    }
+    if (!nodes[b].isLeaf())
+    {
+        float areaB = area(nodes[b].box);
+        uint32_t d = nodes[b].child1, e = nodes[b].child2;
+
+        float delta = area(merge(nodes[c].box, nodes[e].box)) - areaB;
+        if (delta < bestDelta)
+        {
+            rotation = C_D;
+            bestDelta = delta;
+        }
+        delta = area(merge(nodes[c].box, nodes[d].box)) - areaB;
+        if (delta < bestDelta)
+        {
+            rotation = C_E;
+            bestDelta = delta;
+        }
+    }
+
+    // swaps child `outer` of index with one of the children of its sibling `middle`
+    auto swapInto = [&](uint32_t outer, uint32_t middle, bool firstGrandChild)
+    {
+        TreeNode &m = nodes[middle];
+        uint32_t &slot = firstGrandChild ? m.child1 : m.child2;
+        uint32_t grandChild = slot;
+
+        if (nodes[index].child1 == outer)
+            nodes[index].child1 = grandChild;
+        else
+            nodes[index].child2 = grandChild;
+        nodes[grandChild].parent = index;
+
+        slot = outer;
+        nodes[outer].parent = middle;
+
+        m.box = merge(nodes[m.child1].box, nodes[m.child2].box);
+        m.height = 1 + std::max(nodes[m.child1].height, nodes[m.child2].height);
+        nodes[index].height = 1 + std::max(nodes[nodes[index].child1].height, nodes[nodes[index].child2].height);
+    };
+
+    switch (rotation)
+    {
+    case B_F:
+        swapInto(b, c, true);
+        break;
+    case B_G:
+        swapInto(b, c, false);
+        break;
+    case C_D:
+        swapInto(c, b, true);
+        break;
+    case C_E:
+        swapInto(c, b, false);
+        break;
+    default:
+        break;
+    }
+}
+
+float AABBTree::getAreaRatio() const
+{
+    if (root == NONE)
+        return 0.0f;
+
+    float total = 0.0f;
+    for (const TreeNode &node : nodes)
+        if (node.height > 0)
+            total += area(node.box);
+    return total / area(nodes[root].box);
+}
+
+void AABBTree::query(const AABB *boxes, size_t count, TreeQueryResults &results) const
+{
+    results.items.clear();
+    results.offsets.assign(1, 0);
+    for (size_t i = 0; i < count; i++)
+    {
+        query(boxes[i], [&](uint32_t item)
+              { results.items.push_back(item); return true; });
+        results.offsets.push_back(static_cast<uint32_t>(results.items.size()));
+    }
+}
+
+void AABBTree::query(const BoundingSphere *spheres, size_t count, TreeQueryResults &results) const
+{
+    results.items.clear();
+    results.offsets.assign(1, 0);
+    for (size_t i = 0; i < count; i++)
+    {
+        query(spheres[i], [&](uint32_t item)
+              { results.items.push_back(item); return true; });
+        results.offsets.push_back(static_cast<uint32_t>(results.items.size()));
+    }
+}
+
+void AABBTree::query(const Frustum *frustums, size_t count, TreeQueryResults &results) const
+{
+    results.items.clear();
+    results.offsets.assign(1, 0);
+    for (size_t i = 0; i < count; i++)
+    {
+        query(frustums[i], [&](uint32_t item)
+              { results.items.push_back(item); return true; });
+        results.offsets.push_back(static_cast<uint32_t>(results.items.size()));
+    }
+}
+
+void AABBTree::raycast(const TreeRay *rays, size_t count, std::vector<TreeRayHit> &hits) const
+{
+    hits.assign(count, TreeRayHit());
+    for (size_t i = 0; i < count; i++)
+    {
+        TreeRayHit &hit = hits[i];
+        raycast(rays[i], [&](uint32_t item, float distance)
+                {
+                    if (hit.item == NONE || distance < hit.distance)
+                    {
+                        hit.item = item;
+                        hit.distance = distance;
+                    }
+                    // only boxes starting closer can still win, 0 (inside a box) ends the walk
+                    return distance; });
+    }
+}
@@ -1,69 +1,35 @@
+#define GLM_ENABLE_EXPERIMENTAL
 #include "Animator.h"
-#include "Model.h" // For Bone and Skeleton structs
+#include "ModelData.h" // For Bone and Skeleton structs
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/quaternion.hpp>
 
 Animator::Animator() {}
 
-void Animator::loadAnimation(const aiScene *scene)
+void Animator::setAnimations(const std::vector<Animation> *clips)
 {
-    if (!scene || scene->mNumAnimations < 1)
-    {
-        return;
-    }
-
-    animations.clear();
+    animations = clips;
     animationNames.clear();
+    currentAnimationIndex = -1;
+    currentTime = 0.0f;
 
-    for (unsigned int i = 0; i < scene->mNumAnimations; ++i)
-    {
-        aiAnimation *aiAnim = scene->mAnimations[i];
-        Animation anim;
+    if (!animations || animations->empty())
+        return;
 
-        anim.name = aiAnim->mName.C_Str();
+    for (const Animation &anim : *animations)
         animationNames.push_back(anim.name);
 
-        anim.ticksPerSecond = (aiAnim->mTicksPerSecond != 0.0f) ? aiAnim->mTicksPerSecond : 25.0f;
-        anim.duration = aiAnim->mDuration;
-
-        for (unsigned int j = 0; j < aiAnim->mNumChannels; ++j)
-        {
-            aiNodeAnim *channel = aiAnim->mChannels[j];
-            BoneTransformTrack track;
-            for (unsigned int k = 0; k < channel->mNumPositionKeys; ++k)
-            {
-                track.positionTimestamps.push_back(channel->mPositionKeys[k].mTime);
-                track.positions.push_back(assimpToGlmVec3(channel->mPositionKeys[k].mValue));
-            }
-            for (unsigned int k = 0; k < channel->mNumRotationKeys; ++k)
-            {
-                track.rotationTimestamps.push_back(channel->mRotationKeys[k].mTime);
-                track.rotations.push_back(assimpToGlmQuat(channel->mRotationKeys[k].mValue));
-            }
-            for (unsigned int k = 0; k < channel->mNumScalingKeys; ++k)
-            {
-                track.scaleTimestamps.push_back(channel->mScalingKeys[k].mTime);
-                track.scales.push_back(assimpToGlmVec3(channel->mScalingKeys[k].mValue));
-            }
-            anim.boneTransforms[channel->mNodeName.C_Str()] = track;
-        }
-        animations.push_back(anim);
-    }
-
-    if (!animations.empty())
-    {
-        currentAnimationIndex = 0; // Default to the first animation
-    }
+    currentAnimationIndex = 0; // Default to the first animation
 }
 
-void Animator::updateAnimation(float deltaTime, Skeleton &skeleton, std::vector<glm::mat4> &finalBoneMatrices, const glm::mat4 &globalInverseTransform)
+void Animator::updateAnimation(float deltaTime, const Skeleton &skeleton, std::vector<glm::mat4> &finalBoneMatrices, const glm::mat4 &globalInverseTransform)
 {
-    if (isPaused || currentAnimationIndex < 0 || animations.empty())
+    if (isPaused || currentAnimationIndex < 0 || !animations || animations->empty())
     {
         return;
     }
 
-    Animation &anim = animations[currentAnimationIndex];
+    const Animation &anim = (*animations)[currentAnimationIndex];
     currentTime += deltaTime * anim.ticksPerSecond;
 
     if (currentTime > anim.duration)
@@ -74,9 +40,9 @@ void Animator::updateAnimation(float deltaTime, Skeleton &skeleton, std::vector<
     updatePose(skeleton, finalBoneMatrices, globalInverseTransform);
 }
 
-void Animator::updatePose(Skeleton &skeleton, std::vector<glm::mat4> &finalBoneMatrices, const glm::mat4 &globalInverseTransform)
+void Animator::updatePose(const Skeleton &skeleton, std::vector<glm::mat4> &finalBoneMatrices, const glm::mat4 &globalInverseTransform)
 {
-    if (currentAnimationIndex < 0 || animations.empty())
+    if (currentAnimationIndex < 0 || !animations || animations->empty())
         return;
 
     if (finalBoneMatrices.size() != skeleton.boneCount)
@@ -85,7 +51,7 @@ void Animator::updatePose(Skeleton &skeleton, std::vector<glm::mat4> &finalBoneM
     }
 
     std::vector<glm::mat4> boneMatrices(skeleton.boneCount);
-    getPose(animations[currentAnimationIndex], skeleton.rootBone, currentTime, boneMatrices, glm::mat4(1.0f), globalInverseTransform);
+    getPose((*animations)[currentAnimationIndex], skeleton.rootBone, currentTime, boneMatrices, glm::mat4(1.0f), globalInverseTransform);
 
     for (size_t i = 0; i < boneMatrices.size(); ++i)
     {
@@ -98,45 +64,45 @@ void Animator::pause() { isPaused = true; }
 
 void Animator::setAnimation(int index)
 {
-    if (index >= 0 && index < animations.size())
+    if (animations && index >= 0 && index < animations->size())
     {
         currentAnimationIndex = index;
         currentTime = 0.0f; // Reset time when changing animation
     }
 }
 
-void Animator::seek(float time, Skeleton &skeleton, std::vector<glm::mat4> &finalBoneMatrices, const glm::mat4 &globalInverseTransform)
+void Animator::seek(float time, const Skeleton &skeleton, std::vector<glm::mat4> &finalBoneMatrices, const glm::mat4 &globalInverseTransform)
 {
-    if (currentAnimationIndex < 0)
+    if (currentAnimationIndex < 0 || !animations)
         return;
-    currentTime = glm::clamp(time, 0.0f, animations[currentAnimationIndex].duration);
+    currentTime = glm::clamp(time, 0.0f, (*animations)[currentAnimationIndex].duration);
     updatePose(skeleton, finalBoneMatrices, globalInverseTransform);
 }
 
-Animation *Animator::getCurrentAnimation()
+const Animation *Animator::getCurrentAnimation()
 {
-    if (currentAnimationIndex < 0 || animations.empty())
+    if (currentAnimationIndex < 0 || !animations || animations->empty())
         return nullptr;
-    return &animations[currentAnimationIndex];
+    return &(*animations)[currentAnimationIndex];
 }
 
 // The rest of the file (getPose, getTimeFraction, etc.) remains the same.
 // Make sure these helpers are also in the file.
-void Animator::getPose(Animation &animation, Bone &skeletonBone, float dt, std::vector<glm::mat4> &output, const glm::mat4 &parentTransform, const glm::mat4 &globalInverseTransform)
+void Animator::getPose(const Animation &animation, const Bone &skeletonBone, float dt, std::vector<glm::mat4> &output, const glm::mat4 &parentTransform, const glm::mat4 &globalInverseTransform)
 {
     auto it = animation.boneTransforms.find(skeletonBone.name);
     if (it == animation.boneTransforms.end())
     {
         glm::mat4 globalTransform = parentTransform;
         output[skeletonBone.id] = globalInverseTransform * globalTransform * skeletonBone.offset;
-        for (Bone &child : skeletonBone.children)
+        for (const Bone &child : skeletonBone.children)
         {
             getPose(animation, child, dt, output, globalTransform, globalInverseTransform);
         }
         return;
     }
 
-    BoneTransformTrack &btt = it->second;
+    const BoneTransformTrack &btt = it->second;
 
     glm::vec3 position;
     if (btt.positions.size() > 1)
@@ -174,13 +140,13 @@ void Animator::getPose(Animation &animation, Bone &skeletonBone, float dt, std::
     glm::mat4 localTransform = glm::translate(glm::mat4(1.0f), position) * glm::toMat4(rotation) * glm::scale(glm::mat4(1.0f), scale);
     glm::mat4 globalTransform = parentTransform * localTransform;
     output[skeletonBone.id] = globalInverseTransform * globalTransform * skeletonBone.offset;
-    for (Bone &child : skeletonBone.children)
+    for (const Bone &child : skeletonBone.children)
     {
         getPose(animation, child, dt, output, globalTransform, globalInverseTransform);
     }
 }
 
-std::pair<unsigned int, float> Animator::getTimeFraction(std::vector<float> &times, float &dt)
+std::pair<unsigned int, float> Animator::getTimeFraction(const std::vector<float> &times, float &dt)
 {
     unsigned int segment = 1;
     while (segment < times.size() && dt > times[segment])
@@ -196,6 +162,3 @@ std::pair<unsigned int, float> Animator::getTimeFraction(std::vector<float> &tim
     float frac = (end - start > 0.0f) ? (dt - start) / (end - start) : 0.0f;
     return {segment, frac};
 }
-
-glm::vec3 Animator::assimpToGlmVec3(const aiVector3D &vec) { return glm::vec3(vec.x, vec.y, vec.z); }
-glm::quat Animator::assimpToGlmQuat(const aiQuaternion &quat) { return glm::quat(quat.w, quat.x, quat.y, quat.z); }
\ No newline at end of file
@@ -0,0 +1,315 @@
+#include "AssetCache.h"
+#include "GLState.h"
+
+#include <chrono>
+#include <unordered_set>
+
+namespace
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    float elapsedMs(Clock::time_point start)
+    {
+        return std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+    }
+}
+
+AssetCache::AssetCache(JobSystem &jobs, GeometryArena &geometry) : jobs(jobs), geometry(geometry)
+{
+}
+
+AssetCache::~AssetCache()
+{
+    // jobs write into this object, let the in-flight ones land first
+    jobs.waitIdle();
+    for (auto &[path, image] : images)
+        Texture::FreeImage(image->image);
+}
+
+std::shared_ptr<ModelAsset> AssetCache::loadModel(const std::string &path)
+{
+    auto it = models.find(path);
+    if (it != models.end())
+    {
+        std::cout << "[AssetCache] Reusing " << path << " (" << it->second.use_count() << " users)" << std::endl;
+        return it->second;
+    }
+
+    // failed imports stay cached too, so spawning many copies of a broken file only reports it once
+    std::shared_ptr<ModelAsset> asset = std::make_shared<ModelAsset>(path);
+    asset->placeholder = getPlaceholder();
+    models.emplace(path, asset);
+    loading++;
+
+    jobs.submit([this, asset]
+                { importJob(asset); });
+    return asset;
+}
+
+void AssetCache::importJob(const std::shared_ptr<ModelAsset> &asset)
+{
+    auto start = Clock::now();
+
+    std::unique_ptr<PendingUpload> upload = std::make_unique<PendingUpload>();
+    upload->asset = asset;
+    upload->failed = !ModelAsset::loadData(asset->path, upload->data);
+
+    if (!upload->failed)
+    {
+        for (const MeshData &mesh : upload->data.meshes)
+            for (const MaterialTexture &texture : mesh.textures)
+                decodeImage(texture.path);
+
+        // skinned meshes move away from their bind pose, they cannot stand in as occluders
+        if (!upload->data.hasAnimation)
+        {
+            for (const MeshData &mesh : upload->data.meshes)
+            {
+                if (mesh.indexCount / 3 > MAX_OCCLUDER_TRIANGLES)
+                    continue;
+
+                OccluderMesh occluder;
+                occluder.positions.reserve(mesh.vertexCount);
+                for (uint32_t i = 0; i < mesh.vertexCount; i++)
+                    occluder.positions.push_back(mesh.vertices[i].postition);
+                occluder.indices.assign(mesh.indices, mesh.indices + mesh.indexCount);
+                upload->occluderMeshes.push_back(std::move(occluder));
+            }
+        }
+    }
+    upload->importMs = elapsedMs(start);
+
+    std::lock_guard<std::mutex> lock(finishedMutex);
+    finished.push_back(std::move(upload));
+}
+
+void AssetCache::decodeImage(const std::string &path)
+{
+    std::shared_ptr<PendingImage> image;
+    {
+        std::lock_guard<std::mutex> lock(imageMutex);
+        if (images.count(path))
+            return;
+        image = std::make_shared<PendingImage>();
+        images.emplace(path, image);
+    }
+
+    Texture::Decode(path, image->image);
+    image->ready.store(true, std::memory_order_release);
+}
+
+bool AssetCache::hasPendingUploads()
+{
+    if (!uploading.empty())
+        return true;
+    std::lock_guard<std::mutex> lock(finishedMutex);
+    return !finished.empty();
+}
+
+void AssetCache::processUploads()
+{
+    {
+        std::lock_guard<std::mutex> lock(finishedMutex);
+        for (std::unique_ptr<PendingUpload> &upload : finished)
+            uploading.push_back(std::move(upload));
+        finished.clear();
+    }
+
+    if (uploading.empty())
+        return;
+
+    auto start = Clock::now();
+    auto overBudget = [&]
+    { return elapsedMs(start) >= uploadBudgetMs; };
+
+    // always gets at least one mesh in, even on a slow frame
+    for (size_t i = 0; i < uploading.size() && !overBudget();)
+    {
+        PendingUpload &upload = *uploading[i];
+
+        if (!upload.failed)
+        {
+            while (upload.nextMesh < upload.data.meshes.size() && !overBudget())
+            {
+                if (!uploadStep(upload))
+                    break;
+            }
+        }
+
+        if (upload.failed || upload.nextMesh == upload.data.meshes.size())
+        {
+            finishUpload(upload);
+            uploading.erase(uploading.begin() + i);
+        }
+        else
+            i++;
+    }
+}
+
+bool AssetCache::uploadStep(PendingUpload &upload)
+{
+    const MeshData &meshData = upload.data.meshes[upload.nextMesh];
+
+    std::vector<Texture> meshTextures;
+    for (const MaterialTexture &texture : meshData.textures)
+    {
+        const Texture *resolved = resolveTexture(texture);
+        if (!resolved)
+            return false;
+        // the GL texture is shared by path, type and unit belong to this material
+        meshTextures.push_back(resolved->withBinding(texture.unit, texture.type));
+    }
+
+    upload.asset->meshes.emplace_back(geometry, meshData.vertices, meshData.vertexCount, meshData.indices, meshData.indexCount, meshTextures);
+    upload.asset->meshes.back().setBounds(meshData.bounds);
+    upload.nextMesh++;
+    return true;
+}
+
+const Texture *AssetCache::resolveTexture(const MaterialTexture &texture)
+{
+    auto it = textures.find(texture.path);
+    if (it != textures.end())
+        return &it->second;
+
+    std::shared_ptr<PendingImage> image;
+    {
+        std::lock_guard<std::mutex> lock(imageMutex);
+        auto pending = images.find(texture.path);
+        if (pending != images.end())
+        {
+            if (!pending->second->ready.load(std::memory_order_acquire))
+                return nullptr;
+            image = pending->second;
+        }
+    }
+
+    // nobody decoded it (released since the import), do it here
+    if (!image)
+    {
+        image = std::make_shared<PendingImage>();
+        Texture::Decode(texture.path, image->image);
+        std::lock_guard<std::mutex> lock(imageMutex);
+        images[texture.path] = image;
+    }
+
+    Texture uploaded(texture.path, image->image, GL_TEXTURE_2D, texture.unit, texture.type);
+    Texture::FreeImage(image->image);
+    return &textures.emplace(texture.path, uploaded).first->second;
+}
+
+void AssetCache::finishUpload(PendingUpload &upload)
+{
+    ModelAsset &asset = *upload.asset;
+    loading--;
+
+    if (upload.failed)
+    {
+        asset.state = AssetState::Failed;
+        std::cerr << "[AssetCache] Failed to load: " << asset.path << std::endl;
+        return;
+    }
+
+    asset.skeleton = std::move(upload.data.skeleton);
+    asset.animations = std::move(upload.data.animations);
+    asset.globalInverseTransform = upload.data.globalInverseTransform;
+    asset.hasAnimation = upload.data.hasAnimation;
+    asset.occluderMeshes = std::move(upload.occluderMeshes);
+    asset.state = AssetState::Ready;
+
+    std::cout << "[AssetCache] " << asset.path << " ready (" << asset.meshes.size() << " meshes, "
+              << asset.animations.size() << " clips, imported in " << upload.importMs << " ms)" << std::endl;
+}
+
+void AssetCache::releaseUnused()
+{
+    for (auto it = models.begin(); it != models.end();)
+    {
+        // the cache's own reference is the only one left, and no job still works on it
+        if (it->second.use_count() == 1 && it->second->state != AssetState::Loading)
+        {
+            std::cout << "[AssetCache] Releasing " << it->first << std::endl;
+            it = models.erase(it);
+        }
+        else
+            ++it;
+    }
+
+    // loading assets may still pick up any texture, only prune once everything landed
+    if (loading > 0)
+        return;
+
+    std::unordered_set<unsigned int> usedTextures;
+    for (auto &[path, asset] : models)
+        for (const Mesh &mesh : asset->meshes)
+            for (const Texture &texture : mesh.textures)
+                usedTextures.insert(texture.ID);
+
+    std::lock_guard<std::mutex> lock(imageMutex);
+    for (auto it = textures.begin(); it != textures.end();)
+    {
+        if (usedTextures.count(it->second.ID) == 0)
+        {
+            GLState::DeleteTexture(it->second.ID);
+            images.erase(it->first);
+            it = textures.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+void AssetCache::clear()
+{
+    jobs.waitIdle();
+    finished.clear();
+    uploading.clear();
+    loading = 0;
+
+    models.clear();
+    for (auto &[path, texture] : textures)
+        GLState::DeleteTexture(texture.ID);
+    textures.clear();
+
+    for (auto &[path, image] : images)
+        Texture::FreeImage(image->image);
+    images.clear();
+}
+
+const std::shared_ptr<Mesh> &AssetCache::getPlaceholder()
+{
+    if (placeholder)
+        return placeholder;
+
+    // unit cube with per-face normals in the model vertex layout, lit like any other mesh
+    const glm::vec3 normals[6] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+    std::vector<Vertex> vertices;
+    std::vector<unsigned int> indices;
+    for (const glm::vec3 &n : normals)
+    {
+        glm::vec3 u = glm::vec3(n.y, n.z, n.x);
+        glm::vec3 v = glm::cross(n, u);
+        unsigned int base = static_cast<unsigned int>(vertices.size());
+        const glm::vec2 corners[4] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+        for (const glm::vec2 &c : corners)
+        {
+            Vertex vertex;
+            vertex.postition = 0.5f * (n + c.x * u + c.y * v);
+            vertex.normal = n;
+            vertex.texCoords = c * 0.5f + 0.5f;
+            vertices.push_back(vertex);
+        }
+        indices.insert(indices.end(), {base, base + 1, base + 2, base + 2, base + 3, base});
+    }
+
+    // plain white so the lighting alone shows the shape
+    unsigned char white[4] = {255, 255, 255, 255};
+    TextureImage image;
+    image.width = image.height = 1;
+    image.channels = 4;
+    image.pixels = white;
+    std::vector<Texture> placeholderTextures = {Texture("placeholder", image, GL_TEXTURE_2D, 0, "texture_diffuse")};
+
+    placeholder = std::make_shared<Mesh>(vertices.data(), vertices.size(), indices.data(), indices.size(), placeholderTextures);
+    return placeholder;
+}
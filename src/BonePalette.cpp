@@ -0,0 +1,63 @@
+#include "BonePalette.h"
+#include "GLState.h"
+
+#include <cstring>
+
+BonePalette::~BonePalette()
+{
+    GLState::DeleteTexture(textureID);
+}
+
+bool BonePalette::Begin(StreamBuffer &stream, size_t matrixCount)
+{
+    written = capacity = 0;
+    if (matrixCount == 0)
+        return false;
+
+    // matrix aligned, so the shader can index whole matrices from the buffer start
+    allocation = stream.Allocate(matrixCount * sizeof(glm::mat4), sizeof(glm::mat4));
+    if (!allocation)
+        return false;
+    capacity = matrixCount;
+    return true;
+}
+
+unsigned int BonePalette::Append(const std::vector<glm::mat4> &bones)
+{
+    unsigned int first = static_cast<unsigned int>(allocation.offset / sizeof(glm::mat4) + written);
+    if (written + bones.size() > capacity)
+        return first;
+
+    std::memcpy(static_cast<glm::mat4 *>(allocation.data) + written, bones.data(), bones.size() * sizeof(glm::mat4));
+    written += bones.size();
+    return first;
+}
+
+void BonePalette::End(StreamBuffer &stream)
+{
+    if (!allocation)
+        return;
+    stream.Commit(allocation);
+
+    if (!textureID)
+        glGenTextures(1, &textureID);
+
+    // the texture views the whole stream buffer, only re-attached if that buffer changes
+    if (attachedBuffer != allocation.buffer)
+    {
+        GLState::BindTexture(BONE_PALETTE_UNIT, GL_TEXTURE_BUFFER, textureID);
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, allocation.buffer);
+        attachedBuffer = allocation.buffer;
+
+        GLint maxTexels = 0;
+        glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+        if (static_cast<size_t>(maxTexels) < stream.getSegmentSize() * StreamBuffer::FRAMES / 16)
+            std::cerr << "[BonePalette - ERROR] Stream buffer exceeds GL_MAX_TEXTURE_BUFFER_SIZE (" << maxTexels << " texels)" << std::endl;
+    }
+    allocation = StreamAllocation();
+}
+
+void BonePalette::Bind(unsigned int unit)
+{
+    GLState::BindTexture(unit, GL_TEXTURE_BUFFER, textureID);
+}
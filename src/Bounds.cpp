@@ -0,0 +1,171 @@
+#include "Bounds.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FYNIX_SSE 1
+#include <xmmintrin.h>
+#endif
+
+void AABB::expand(const glm::vec3 &point)
+{
+    min = glm::min(min, point);
+    max = glm::max(max, point);
+}
+
+void AABB::expand(const AABB &other)
+{
+    min = glm::min(min, other.min);
+    max = glm::max(max, other.max);
+}
+
+AABB AABB::transformed(const glm::mat4 &matrix) const
+{
+    if (!isValid())
+        return *this;
+
+    AABB result;
+    result.min = result.max = glm::vec3(matrix[3]);
+    for (int column = 0; column < 3; column++)
+    {
+        glm::vec3 axis = glm::vec3(matrix[column]);
+        glm::vec3 a = axis * min[column];
+        glm::vec3 b = axis * max[column];
+        result.min += glm::min(a, b);
+        result.max += glm::max(a, b);
+    }
+    return result;
+}
+
+BoundingSphere BoundingSphere::fromAABB(const AABB &box)
+{
+    BoundingSphere sphere;
+    if (!box.isValid())
+        return sphere;
+    sphere.center = box.center();
+    sphere.radius = glm::length(box.extents());
+    return sphere;
+}
+
+BoundingSphere BoundingSphere::transformed(const glm::mat4 &matrix) const
+{
+    if (!isValid())
+        return *this;
+
+    float scale = std::max({glm::length(glm::vec3(matrix[0])),
+                            glm::length(glm::vec3(matrix[1])),
+                            glm::length(glm::vec3(matrix[2]))});
+
+    BoundingSphere result;
+    result.center = glm::vec3(matrix * glm::vec4(center, 1.0f));
+    result.radius = radius * scale;
+    return result;
+}
+
+Frustum::Frustum()
+{
+    for (int i = 0; i < 8; i++)
+    {
+        nx[i] = ny[i] = nz[i] = 0.0f;
+        d[i] = 1.0f;
+    }
+}
+
+Frustum::Frustum(const glm::mat4 &m) : Frustum()
+{
+    // rows of the matrix, glm is column major
+    glm::vec4 row[4];
+    for (int i = 0; i < 4; i++)
+        row[i] = glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+
+    const glm::vec4 planes[6] = {
+        row[3] + row[0], // left
+        row[3] - row[0], // right
+        row[3] + row[1], // bottom
+        row[3] - row[1], // top
+        row[3] + row[2], // near
+        row[3] - row[2], // far
+    };
+
+    for (int i = 0; i < 6; i++)
+    {
+        float length = glm::length(glm::vec3(planes[i]));
+        glm::vec4 plane = planes[i] / length;
+        nx[i] = plane.x;
+        ny[i] = plane.y;
+        nz[i] = plane.z;
+        d[i] = plane.w;
+    }
+}
+
+bool Frustum::testSphere(const BoundingSphere &sphere) const
+{
+    if (!sphere.isValid())
+        return true;
+
+#ifdef FYNIX_SSE
+    const __m128 cx = _mm_set1_ps(sphere.center.x);
+    const __m128 cy = _mm_set1_ps(sphere.center.y);
+    const __m128 cz = _mm_set1_ps(sphere.center.z);
+    const __m128 negRadius = _mm_set1_ps(-sphere.radius);
+
+    for (int i = 0; i < 8; i += 4)
+    {
+        // distance of the center to four planes at once
+        __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_load_ps(nx + i), cx),
+                                            _mm_mul_ps(_mm_load_ps(ny + i), cy)),
+                                 _mm_add_ps(_mm_mul_ps(_mm_load_ps(nz + i), cz), _mm_load_ps(d + i)));
+        if (_mm_movemask_ps(_mm_cmplt_ps(dist, negRadius)))
+            return false;
+    }
+    return true;
+#else
+    for (int i = 0; i < 6; i++)
+    {
+        float dist = nx[i] * sphere.center.x + ny[i] * sphere.center.y + nz[i] * sphere.center.z + d[i];
+        if (dist < -sphere.radius)
+            return false;
+    }
+    return true;
+#endif
+}
+
+bool Frustum::testAABB(const AABB &box) const
+{
+    if (!box.isValid())
+        return true;
+
+#ifdef FYNIX_SSE
+    const __m128 minX = _mm_set1_ps(box.min.x), maxX = _mm_set1_ps(box.max.x);
+    const __m128 minY = _mm_set1_ps(box.min.y), maxY = _mm_set1_ps(box.max.y);
+    const __m128 minZ = _mm_set1_ps(box.min.z), maxZ = _mm_set1_ps(box.max.z);
+    const __m128 zero = _mm_setzero_ps();
+
+    for (int i = 0; i < 8; i += 4)
+    {
+        __m128 px = _mm_load_ps(nx + i), py = _mm_load_ps(ny + i), pz = _mm_load_ps(nz + i);
+
+        // the corner furthest along each plane normal
+        __m128 cx = _mm_or_ps(_mm_and_ps(_mm_cmpgt_ps(px, zero), maxX), _mm_andnot_ps(_mm_cmpgt_ps(px, zero), minX));
+        __m128 cy = _mm_or_ps(_mm_and_ps(_mm_cmpgt_ps(py, zero), maxY), _mm_andnot_ps(_mm_cmpgt_ps(py, zero), minY));
+        __m128 cz = _mm_or_ps(_mm_and_ps(_mm_cmpgt_ps(pz, zero), maxZ), _mm_andnot_ps(_mm_cmpgt_ps(pz, zero), minZ));
+
+        __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, cx), _mm_mul_ps(py, cy)),
+                                 _mm_add_ps(_mm_mul_ps(pz, cz), _mm_load_ps(d + i)));
+        if (_mm_movemask_ps(_mm_cmplt_ps(dist, zero)))
+            return false;
+    }
+    return true;
+#else
+    for (int i = 0; i < 6; i++)
+    {
+        glm::vec3 corner(nx[i] > 0.0f ? box.max.x : box.min.x,
+                         ny[i] > 0.0f ? box.max.y : box.min.y,
+                         nz[i] > 0.0f ? box.max.z : box.min.z);
+        if (nx[i] * corner.x + ny[i] * corner.y + nz[i] * corner.z + d[i] < 0.0f)
+            return false;
+    }
+    return true;
+#endif
+}
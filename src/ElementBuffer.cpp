@@ -1,18 +1,19 @@
 #include "BufferObjects/ElementBuffer.h"
+#include "GLState.h"
 
 ElementBuffer::ElementBuffer(const void *data, unsigned int size)
 {
     glGenBuffers(1, &ID);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
+    GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
 }
 
 void ElementBuffer::Bind()
 {
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
+    GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ID);
 }
 
 void ElementBuffer::UnBind()
 {
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 }
\ No newline at end of file
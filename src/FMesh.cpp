@@ -0,0 +1,436 @@
+#include "FMesh.h"
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    const char FMESH_MAGIC[4] = {'F', 'M', 'S', 'H'};
+
+    // deeper than any real skeleton, keeps a corrupt file from recursing off the stack
+    constexpr unsigned int MAX_BONE_DEPTH = 256;
+    // Animator sizes its palettes from boneCount, far more than any real rig
+    constexpr uint32_t MAX_BONE_COUNT = 1 << 16;
+
+    // smallest encoding of each meta record, with empty strings and arrays
+    constexpr size_t MIN_BONE_SIZE = sizeof(int32_t) + sizeof(uint32_t) + sizeof(glm::mat4) + sizeof(uint32_t);
+    constexpr size_t MIN_TEXTURE_SIZE = 3 * sizeof(uint32_t);
+    constexpr size_t MIN_ANIMATION_SIZE = sizeof(uint32_t) + 2 * sizeof(float) + sizeof(uint32_t);
+    constexpr size_t MIN_TRACK_SIZE = 7 * sizeof(uint32_t);
+
+    struct SourceStamp
+    {
+        bool exists = false;
+        uint64_t size = 0;
+        int64_t time = 0;
+    };
+
+    SourceStamp stampOf(const std::string &path)
+    {
+        std::error_code ec;
+        SourceStamp stamp;
+        stamp.size = fs::file_size(path, ec);
+        if (ec)
+            return {};
+        auto time = fs::last_write_time(path, ec);
+        if (ec)
+            return {};
+        stamp.time = static_cast<int64_t>(time.time_since_epoch().count());
+        stamp.exists = true;
+        return stamp;
+    }
+
+    uint64_t alignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    class BlobWriter
+    {
+    public:
+        std::vector<unsigned char> bytes;
+
+        void write(const void *src, size_t size)
+        {
+            const unsigned char *p = static_cast<const unsigned char *>(src);
+            bytes.insert(bytes.end(), p, p + size);
+        }
+
+        template <typename T>
+        void put(const T &value) { write(&value, sizeof(T)); }
+
+        void putString(const std::string &str)
+        {
+            put(static_cast<uint32_t>(str.size()));
+            write(str.data(), str.size());
+        }
+
+        template <typename T>
+        void putArray(const std::vector<T> &values)
+        {
+            put(static_cast<uint32_t>(values.size()));
+            write(values.data(), values.size() * sizeof(T));
+        }
+
+        void alignTo(uint64_t alignment) { bytes.resize(alignUp(bytes.size(), alignment), 0); }
+    };
+
+    // bounds checked cursor over the meta block, any overrun turns the whole read into a failure
+    class BlobReader
+    {
+    public:
+        BlobReader(const unsigned char *data, size_t size) : cursor(data), end(data + size) {}
+
+        bool read(void *dst, size_t size)
+        {
+            if (!ok || static_cast<size_t>(end - cursor) < size)
+                return ok = false;
+            std::memcpy(dst, cursor, size);
+            cursor += size;
+            return true;
+        }
+
+        template <typename T>
+        T get()
+        {
+            T value{};
+            read(&value, sizeof(T));
+            return value;
+        }
+
+        std::string getString()
+        {
+            uint32_t size = get<uint32_t>();
+            if (!ok || static_cast<size_t>(end - cursor) < size)
+            {
+                ok = false;
+                return {};
+            }
+            std::string str(reinterpret_cast<const char *>(cursor), size);
+            cursor += size;
+            return str;
+        }
+
+        // reads a record count, failing when that many records of minSize cannot fit in what is left
+        uint32_t getCount(size_t minSize)
+        {
+            uint32_t count = get<uint32_t>();
+            if (!ok || static_cast<size_t>(end - cursor) / minSize < count)
+            {
+                ok = false;
+                return 0;
+            }
+            return count;
+        }
+
+        template <typename T>
+        void getArray(std::vector<T> &values)
+        {
+            uint32_t count = get<uint32_t>();
+            if (!ok || static_cast<size_t>(end - cursor) / sizeof(T) < count)
+            {
+                ok = false;
+                return;
+            }
+            values.resize(count);
+            read(values.data(), count * sizeof(T));
+        }
+
+        bool good() const { return ok; }
+
+    private:
+        const unsigned char *cursor;
+        const unsigned char *end;
+        bool ok = true;
+    };
+
+    void writeBone(BlobWriter &out, const Bone &bone)
+    {
+        out.put(static_cast<int32_t>(bone.id));
+        out.putString(bone.name);
+        out.put(bone.offset);
+        out.put(static_cast<uint32_t>(bone.children.size()));
+        for (const Bone &child : bone.children)
+            writeBone(out, child);
+    }
+
+    // ids index the Animator's bone matrices, so each must lie in [0, boneCount)
+    bool readBone(BlobReader &in, Bone &bone, uint32_t boneCount, unsigned int depth = 0)
+    {
+        if (depth > MAX_BONE_DEPTH)
+            return false;
+
+        bone.id = in.get<int32_t>();
+        bone.name = in.getString();
+        bone.offset = in.get<glm::mat4>();
+        uint32_t childCount = in.getCount(MIN_BONE_SIZE);
+        if (!in.good())
+            return false;
+
+        // a model without bones still writes the default root, which is never posed
+        if (boneCount == 0)
+            return childCount == 0;
+        if (bone.id < 0 || static_cast<uint32_t>(bone.id) >= boneCount)
+            return false;
+
+        bone.children.resize(childCount);
+        for (Bone &child : bone.children)
+            if (!readBone(in, child, boneCount, depth + 1))
+                return false;
+        return true;
+    }
+
+    void writeMeta(BlobWriter &out, const ModelData &data)
+    {
+        for (const MeshData &mesh : data.meshes)
+        {
+            out.put(static_cast<uint32_t>(mesh.textures.size()));
+            for (const MaterialTexture &texture : mesh.textures)
+            {
+                out.putString(texture.path);
+                out.putString(texture.type);
+                out.put(static_cast<uint32_t>(texture.unit));
+            }
+        }
+
+        out.put(static_cast<uint32_t>(data.skeleton.boneCount));
+        writeBone(out, data.skeleton.rootBone);
+
+        out.put(static_cast<uint32_t>(data.animations.size()));
+        for (const Animation &anim : data.animations)
+        {
+            out.putString(anim.name);
+            out.put(anim.duration);
+            out.put(anim.ticksPerSecond);
+            out.put(static_cast<uint32_t>(anim.boneTransforms.size()));
+            for (const auto &[boneName, track] : anim.boneTransforms)
+            {
+                out.putString(boneName);
+                out.putArray(track.positionTimestamps);
+                out.putArray(track.positions);
+                out.putArray(track.rotationTimestamps);
+                out.putArray(track.rotations);
+                out.putArray(track.scaleTimestamps);
+                out.putArray(track.scales);
+            }
+        }
+    }
+
+    bool readMeta(BlobReader &in, ModelData &data)
+    {
+        for (MeshData &mesh : data.meshes)
+        {
+            uint32_t textureCount = in.getCount(MIN_TEXTURE_SIZE);
+            for (uint32_t i = 0; i < textureCount && in.good(); i++)
+            {
+                MaterialTexture texture;
+                texture.path = in.getString();
+                texture.type = in.getString();
+                texture.unit = in.get<uint32_t>();
+                mesh.textures.push_back(texture);
+            }
+        }
+
+        data.skeleton.boneCount = in.get<uint32_t>();
+        if (data.skeleton.boneCount > MAX_BONE_COUNT ||
+            !readBone(in, data.skeleton.rootBone, data.skeleton.boneCount))
+            return false;
+
+        uint32_t animationCount = in.getCount(MIN_ANIMATION_SIZE);
+        for (uint32_t i = 0; i < animationCount && in.good(); i++)
+        {
+            Animation anim;
+            anim.name = in.getString();
+            anim.duration = in.get<float>();
+            anim.ticksPerSecond = in.get<float>();
+
+            uint32_t trackCount = in.getCount(MIN_TRACK_SIZE);
+            for (uint32_t t = 0; t < trackCount && in.good(); t++)
+            {
+                std::string boneName = in.getString();
+                BoneTransformTrack &track = anim.boneTransforms[boneName];
+                in.getArray(track.positionTimestamps);
+                in.getArray(track.positions);
+                in.getArray(track.rotationTimestamps);
+                in.getArray(track.rotations);
+                in.getArray(track.scaleTimestamps);
+                in.getArray(track.scales);
+            }
+            data.animations.push_back(std::move(anim));
+        }
+
+        return in.good();
+    }
+}
+
+std::string FMesh::cookedPath(const std::string &sourcePath)
+{
+    return sourcePath + ".fmesh";
+}
+
+bool FMesh::write(const std::string &path, const std::string &sourcePath, const ModelData &data)
+{
+    SourceStamp stamp = stampOf(sourcePath);
+
+    FMeshHeader header = {};
+    std::memcpy(header.magic, FMESH_MAGIC, sizeof(header.magic));
+    header.version = FMESH_VERSION;
+    header.meshCount = static_cast<uint32_t>(data.meshes.size());
+    header.hasAnimation = data.hasAnimation ? 1 : 0;
+    header.sourceSize = stamp.size;
+    header.sourceTime = stamp.time;
+    std::memcpy(header.globalInverseTransform, &data.globalInverseTransform[0][0], sizeof(header.globalInverseTransform));
+
+    BlobWriter out;
+    out.put(header);
+    size_t entriesOffset = out.bytes.size();
+    out.bytes.resize(entriesOffset + data.meshes.size() * sizeof(FMeshEntry));
+
+    std::vector<FMeshEntry> entries(data.meshes.size());
+    for (size_t i = 0; i < data.meshes.size(); i++)
+    {
+        const MeshData &mesh = data.meshes[i];
+        FMeshEntry &entry = entries[i];
+        entry.vertexCount = mesh.vertexCount;
+        entry.indexCount = mesh.indexCount;
+        std::memcpy(entry.boundsMin, &mesh.bounds.min[0], sizeof(entry.boundsMin));
+        std::memcpy(entry.boundsMax, &mesh.bounds.max[0], sizeof(entry.boundsMax));
+
+        out.alignTo(FMESH_ALIGNMENT);
+        entry.vertexOffset = out.bytes.size();
+        out.write(mesh.vertices, mesh.vertexCount * sizeof(Vertex));
+
+        out.alignTo(FMESH_ALIGNMENT);
+        entry.indexOffset = out.bytes.size();
+        out.write(mesh.indices, mesh.indexCount * sizeof(uint32_t));
+    }
+    std::memcpy(out.bytes.data() + entriesOffset, entries.data(), entries.size() * sizeof(FMeshEntry));
+
+    out.alignTo(FMESH_ALIGNMENT);
+    header.metaOffset = out.bytes.size();
+    writeMeta(out, data);
+    header.metaSize = out.bytes.size() - header.metaOffset;
+    std::memcpy(out.bytes.data(), &header, sizeof(header));
+
+    // written aside and swapped in, so an interrupted cook never leaves a truncated blob behind
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+        {
+            std::cerr << "[FMesh] Could not open " << tempPath << " for writing." << std::endl;
+            return false;
+        }
+        file.write(reinterpret_cast<const char *>(out.bytes.data()), out.bytes.size());
+        if (!file)
+        {
+            std::cerr << "[FMesh] Failed writing " << tempPath << std::endl;
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::remove(path, ec);
+    fs::rename(tempPath, path, ec);
+    if (ec)
+    {
+        std::cerr << "[FMesh] Could not move cooked file into place: " << ec.message() << std::endl;
+        fs::remove(tempPath, ec);
+        return false;
+    }
+
+    std::cout << "[FMesh] Cooked " << sourcePath << " -> " << path << " (" << out.bytes.size() / 1024 << " KB)" << std::endl;
+    return true;
+}
+
+bool FMesh::read(const std::string &path, const std::string &sourcePath, ModelData &data)
+{
+    MappedFile file;
+    if (!file.open(path))
+        return false;
+
+    const unsigned char *base = file.getData();
+    const size_t size = file.getSize();
+
+    FMeshHeader header;
+    if (size < sizeof(header))
+        return false;
+    std::memcpy(&header, base, sizeof(header));
+
+    if (std::memcmp(header.magic, FMESH_MAGIC, sizeof(header.magic)) != 0 || header.version != FMESH_VERSION)
+    {
+        std::cout << "[FMesh] " << path << " is from another format version, recooking." << std::endl;
+        return false;
+    }
+
+    // only checked when the source is around, a shipped build may contain cooked files alone
+    SourceStamp stamp = stampOf(sourcePath);
+    if (stamp.exists && (stamp.size != header.sourceSize || stamp.time != header.sourceTime))
+    {
+        std::cout << "[FMesh] " << path << " is older than its source, recooking." << std::endl;
+        return false;
+    }
+
+    const uint64_t entriesEnd = sizeof(header) + uint64_t(header.meshCount) * sizeof(FMeshEntry);
+    if (entriesEnd > size || header.metaOffset > size || header.metaSize > size - header.metaOffset)
+    {
+        std::cerr << "[FMesh] " << path << " is truncated." << std::endl;
+        return false;
+    }
+
+    data.meshes.resize(header.meshCount);
+    for (uint32_t i = 0; i < header.meshCount; i++)
+    {
+        FMeshEntry entry;
+        std::memcpy(&entry, base + sizeof(header) + i * sizeof(FMeshEntry), sizeof(entry));
+
+        uint64_t vertexBytes = uint64_t(entry.vertexCount) * sizeof(Vertex);
+        uint64_t indexBytes = uint64_t(entry.indexCount) * sizeof(uint32_t);
+        if (entry.vertexOffset > size || vertexBytes > size - entry.vertexOffset ||
+            entry.indexOffset > size || indexBytes > size - entry.indexOffset ||
+            entry.vertexOffset % alignof(Vertex) != 0 || entry.indexOffset % alignof(uint32_t) != 0)
+        {
+            std::cerr << "[FMesh] " << path << " has a corrupt mesh table." << std::endl;
+            data.meshes.clear();
+            return false;
+        }
+
+        // the occluder and the GPU index straight into the vertices
+        const uint32_t *indices = reinterpret_cast<const uint32_t *>(base + entry.indexOffset);
+        for (uint32_t index = 0; index < entry.indexCount; index++)
+        {
+            if (indices[index] >= entry.vertexCount)
+            {
+                std::cerr << "[FMesh] " << path << " has an index past its vertices." << std::endl;
+                data.meshes.clear();
+                return false;
+            }
+        }
+
+        MeshData &mesh = data.meshes[i];
+        mesh.vertices = reinterpret_cast<const Vertex *>(base + entry.vertexOffset);
+        mesh.vertexCount = entry.vertexCount;
+        mesh.indices = indices;
+        mesh.indexCount = entry.indexCount;
+        std::memcpy(&mesh.bounds.min[0], entry.boundsMin, sizeof(entry.boundsMin));
+        std::memcpy(&mesh.bounds.max[0], entry.boundsMax, sizeof(entry.boundsMax));
+    }
+
+    BlobReader meta(base + header.metaOffset, header.metaSize);
+    if (!readMeta(meta, data))
+    {
+        std::cerr << "[FMesh] " << path << " has a corrupt meta block." << std::endl;
+        data = ModelData();
+        return false;
+    }
+
+    std::memcpy(&data.globalInverseTransform[0][0], header.globalInverseTransform, sizeof(header.globalInverseTransform));
+    data.hasAnimation = header.hasAnimation != 0;
+    data.mapping = std::move(file);
+    return true;
+}
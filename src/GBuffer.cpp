@@ -0,0 +1,106 @@
+#include "GBuffer.h"
+#include "GLState.h"
+
+#include <iostream>
+
+GBuffer::~GBuffer()
+{
+    destroy();
+    GLState::DeleteVertexArray(emptyVAO);
+}
+
+bool GBuffer::create(int newWidth, int newHeight)
+{
+    destroy();
+    width = newWidth;
+    height = newHeight;
+
+    struct Target
+    {
+        GLenum internalFormat, format, type, attachment;
+    };
+    const Target targets[3] = {
+        {GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, GL_COLOR_ATTACHMENT0},
+        {GL_RG16, GL_RG, GL_UNSIGNED_SHORT, GL_COLOR_ATTACHMENT1},
+        {GL_DEPTH_COMPONENT24, GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, GL_DEPTH_ATTACHMENT}};
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+    glGenTextures(3, textures);
+    for (int i = 0; i < 3; i++)
+    {
+        // the lighting pass reads texel for pixel, no filtering or mips
+        GLState::BindTexture(GL_TEXTURE_2D, textures[i]);
+        glTexImage2D(GL_TEXTURE_2D, 0, targets[i].internalFormat, width, height, 0, targets[i].format, targets[i].type, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, targets[i].attachment, GL_TEXTURE_2D, textures[i], 0);
+    }
+
+    const GLenum drawBuffers[2] = {GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1};
+    glDrawBuffers(2, drawBuffers);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cerr << "[GBuffer - ERROR] Framebuffer incomplete (0x" << std::hex << status << std::dec << ")" << std::endl;
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        destroy();
+        return false;
+    }
+
+    std::cout << "[GBuffer] Created " << width << "x" << height << " targets, "
+              << (size_t(width) * height * BYTES_PER_PIXEL) / (1024 * 1024) << " MB" << std::endl;
+    return true;
+}
+
+void GBuffer::destroy()
+{
+    for (unsigned int &texture : textures)
+    {
+        GLState::DeleteTexture(texture);
+        texture = 0;
+    }
+    if (framebuffer)
+        glDeleteFramebuffers(1, &framebuffer);
+    framebuffer = 0;
+    width = height = 0;
+}
+
+void GBuffer::Begin(int newWidth, int newHeight)
+{
+    if (newWidth <= 0 || newHeight <= 0)
+        return;
+    if ((newWidth != width || newHeight != height) && !create(newWidth, newHeight))
+        return;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, width, height);
+    // zero albedo and normal are never read, the lighting pass skips pixels left at the far plane
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+void GBuffer::End(unsigned int target)
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, target);
+}
+
+void GBuffer::BindTextures()
+{
+    GLState::BindTexture(GBUFFER_ALBEDO_UNIT, GL_TEXTURE_2D, textures[0]);
+    GLState::BindTexture(GBUFFER_NORMAL_UNIT, GL_TEXTURE_2D, textures[1]);
+    GLState::BindTexture(GBUFFER_DEPTH_UNIT, GL_TEXTURE_2D, textures[2]);
+}
+
+void GBuffer::DrawFullscreen()
+{
+    // core profile wants a vertex array bound even when nothing is read from it
+    if (!emptyVAO)
+        glGenVertexArrays(1, &emptyVAO);
+    GLState::BindVertexArray(emptyVAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+}
@@ -0,0 +1,82 @@
+#include "GLExtensions.h"
+
+#include <cstring>
+#include <iostream>
+
+int GLExtensions::major = 3;
+int GLExtensions::minor = 3;
+
+bool GLExtensions::multiDrawIndirect = false;
+PFN_glMultiDrawElementsIndirect GLExtensions::MultiDrawElementsIndirect = nullptr;
+
+bool GLExtensions::bufferStorage = false;
+PFN_glBufferStorage GLExtensions::BufferStorage = nullptr;
+
+bool GLExtensions::programBinary = false;
+PFN_glGetProgramBinary GLExtensions::GetProgramBinary = nullptr;
+PFN_glProgramBinary GLExtensions::ProgramBinary = nullptr;
+PFN_glProgramParameteri GLExtensions::ProgramParameteri = nullptr;
+
+bool GLExtensions::parallelShaderCompile = false;
+PFN_glMaxShaderCompilerThreads GLExtensions::MaxShaderCompilerThreads = nullptr;
+
+bool GLExtensions::Has(const char *extension)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; i++)
+    {
+        const char *name = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, i));
+        if (name && std::strcmp(name, extension) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool GLExtensions::AtLeast(int wantMajor, int wantMinor)
+{
+    return major > wantMajor || (major == wantMajor && minor >= wantMinor);
+}
+
+void GLExtensions::Load()
+{
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+    // per-draw data comes in through baseInstance, so base instance support is required as well
+    if (AtLeast(4, 3) || (Has("GL_ARB_multi_draw_indirect") && Has("GL_ARB_base_instance")))
+    {
+        MultiDrawElementsIndirect = (PFN_glMultiDrawElementsIndirect)glfwGetProcAddress("glMultiDrawElementsIndirect");
+        multiDrawIndirect = MultiDrawElementsIndirect != nullptr;
+    }
+
+    if (AtLeast(4, 4) || Has("GL_ARB_buffer_storage"))
+    {
+        BufferStorage = (PFN_glBufferStorage)glfwGetProcAddress("glBufferStorage");
+        bufferStorage = BufferStorage != nullptr;
+    }
+
+    // some drivers expose the entry points but offer no format to save in
+    if (AtLeast(4, 1) || Has("GL_ARB_get_program_binary"))
+    {
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        GetProgramBinary = (PFN_glGetProgramBinary)glfwGetProcAddress("glGetProgramBinary");
+        ProgramBinary = (PFN_glProgramBinary)glfwGetProcAddress("glProgramBinary");
+        ProgramParameteri = (PFN_glProgramParameteri)glfwGetProcAddress("glProgramParameteri");
+        programBinary = formats > 0 && GetProgramBinary && ProgramBinary && ProgramParameteri;
+    }
+
+    // both spell the entry point with their own suffix, the enums are shared
+    if (Has("GL_KHR_parallel_shader_compile"))
+        MaxShaderCompilerThreads = (PFN_glMaxShaderCompilerThreads)glfwGetProcAddress("glMaxShaderCompilerThreadsKHR");
+    else if (Has("GL_ARB_parallel_shader_compile"))
+        MaxShaderCompilerThreads = (PFN_glMaxShaderCompilerThreads)glfwGetProcAddress("glMaxShaderCompilerThreadsARB");
+    parallelShaderCompile = MaxShaderCompilerThreads != nullptr;
+
+    std::cout << "[GLExtensions] OpenGL " << major << "." << minor
+              << ", multi-draw indirect: " << (multiDrawIndirect ? "yes" : "no")
+              << ", buffer storage: " << (bufferStorage ? "yes" : "no")
+              << ", program binaries: " << (programBinary ? "yes" : "no")
+              << ", parallel shader compile: " << (parallelShaderCompile ? "yes" : "no") << std::endl;
+}
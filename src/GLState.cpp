@@ -0,0 +1,207 @@
+#include "GLState.h"
+
+#include <initializer_list>
+
+namespace
+{
+    // texture targets with a shadow slot per unit, others always hit the driver
+    enum TextureSlot
+    {
+        SLOT_2D,
+        SLOT_BUFFER,
+        SLOT_CUBE_MAP,
+        SLOT_COUNT,
+    };
+
+    struct State
+    {
+        unsigned int program = 0;
+        unsigned int vao = 0;
+        unsigned int arrayBuffer = 0;
+        unsigned int elementBuffer = 0; // of the bound VAO
+        unsigned int uniformBuffer = 0;
+        unsigned int textureBuffer = 0;
+
+        unsigned int activeUnit = 0;
+        unsigned int textures[GLState::MAX_TEXTURE_UNITS][SLOT_COUNT] = {};
+
+        bool blend = false;
+        GLenum blendSrc = GL_ONE, blendDst = GL_ZERO;
+        GLenum polygonMode = GL_FILL;
+
+        bool counting = false;
+        GLStateStats frame, lastFrame;
+    };
+
+    // starts out matching the defaults of a fresh context
+    State state;
+
+    int textureSlot(GLenum target)
+    {
+        switch (target)
+        {
+        case GL_TEXTURE_2D:
+            return SLOT_2D;
+        case GL_TEXTURE_BUFFER:
+            return SLOT_BUFFER;
+        case GL_TEXTURE_CUBE_MAP:
+            return SLOT_CUBE_MAP;
+        default:
+            return -1;
+        }
+    }
+
+    unsigned int *bufferSlot(GLenum target)
+    {
+        switch (target)
+        {
+        case GL_ARRAY_BUFFER:
+            return &state.arrayBuffer;
+        case GL_ELEMENT_ARRAY_BUFFER:
+            return &state.elementBuffer;
+        case GL_UNIFORM_BUFFER:
+            return &state.uniformBuffer;
+        case GL_TEXTURE_BUFFER:
+            return &state.textureBuffer;
+        default:
+            return nullptr;
+        }
+    }
+
+    // true when the call has to reach GL
+    bool changed(unsigned int &cached, unsigned int value)
+    {
+        bool differs = cached != value;
+        cached = value;
+        if (state.counting)
+            (differs ? state.frame.issued : state.frame.skipped)++;
+        return differs;
+    }
+}
+
+void GLState::UseProgram(unsigned int program)
+{
+    if (changed(state.program, program))
+        glUseProgram(program);
+}
+
+void GLState::BindVertexArray(unsigned int vao)
+{
+    if (!changed(state.vao, vao))
+        return;
+    glBindVertexArray(vao);
+    // the element binding lives in the VAO, we do not know the new one's
+    state.elementBuffer = ~0u;
+}
+
+void GLState::BindBuffer(GLenum target, unsigned int buffer)
+{
+    unsigned int *slot = bufferSlot(target);
+    if (!slot || changed(*slot, buffer))
+        glBindBuffer(target, buffer);
+}
+
+void GLState::ActiveTexture(unsigned int unit)
+{
+    if (changed(state.activeUnit, unit))
+        glActiveTexture(GL_TEXTURE0 + unit);
+}
+
+void GLState::BindTexture(unsigned int unit, GLenum target, unsigned int texture)
+{
+    int slot = textureSlot(target);
+    if (slot >= 0 && unit < MAX_TEXTURE_UNITS && !changed(state.textures[unit][slot], texture))
+        return;
+
+    ActiveTexture(unit);
+    glBindTexture(target, texture);
+}
+
+void GLState::BindTexture(GLenum target, unsigned int texture)
+{
+    BindTexture(state.activeUnit, target, texture);
+}
+
+void GLState::SetBlend(bool enabled)
+{
+    unsigned int cached = state.blend;
+    if (!changed(cached, enabled))
+        return;
+    state.blend = enabled;
+    if (enabled)
+        glEnable(GL_BLEND);
+    else
+        glDisable(GL_BLEND);
+}
+
+void GLState::BlendFunc(GLenum src, GLenum dst)
+{
+    bool srcChanged = changed(state.blendSrc, src);
+    bool dstChanged = changed(state.blendDst, dst);
+    if (srcChanged || dstChanged)
+        glBlendFunc(src, dst);
+}
+
+void GLState::PolygonMode(GLenum mode)
+{
+    // core profile only accepts GL_FRONT_AND_BACK
+    if (changed(state.polygonMode, mode))
+        glPolygonMode(GL_FRONT_AND_BACK, mode);
+}
+
+void GLState::DeleteTexture(unsigned int texture)
+{
+    if (!texture)
+        return;
+    glDeleteTextures(1, &texture);
+    // GL unbinds it from every unit, so do we
+    for (auto &unit : state.textures)
+        for (unsigned int &bound : unit)
+            if (bound == texture)
+                bound = 0;
+}
+
+void GLState::DeleteBuffer(unsigned int buffer)
+{
+    if (!buffer)
+        return;
+    glDeleteBuffers(1, &buffer);
+    for (unsigned int *slot : {&state.arrayBuffer, &state.elementBuffer, &state.uniformBuffer, &state.textureBuffer})
+        if (*slot == buffer)
+            *slot = 0;
+}
+
+void GLState::DeleteVertexArray(unsigned int vao)
+{
+    if (!vao)
+        return;
+    glDeleteVertexArrays(1, &vao);
+    if (state.vao == vao)
+    {
+        state.vao = 0;
+        state.elementBuffer = ~0u;
+    }
+}
+
+void GLState::SetCounting(bool enabled)
+{
+    state.counting = enabled;
+    if (!enabled)
+        state.frame = state.lastFrame = GLStateStats();
+}
+
+bool GLState::IsCounting()
+{
+    return state.counting;
+}
+
+void GLState::EndFrame()
+{
+    state.lastFrame = state.frame;
+    state.frame = GLStateStats();
+}
+
+const GLStateStats &GLState::getStats()
+{
+    return state.lastFrame;
+}
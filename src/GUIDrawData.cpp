@@ -0,0 +1,49 @@
+#include "GUIDrawData.h"
+
+GUIDrawData::~GUIDrawData()
+{
+    for (ImDrawList *list : lists)
+        IM_DELETE(list);
+}
+
+void GUIDrawData::clear()
+{
+    data.Clear();
+}
+
+void GUIDrawData::copy(const ImDrawData &source)
+{
+    data.Clear();
+    if (!source.Valid)
+        return;
+
+    for (int i = 0; i < source.CmdListsCount; i++)
+    {
+        if (static_cast<size_t>(i) == lists.size())
+            lists.push_back(IM_NEW(ImDrawList)(ImGui::GetDrawListSharedData()));
+
+        const ImDrawList *from = source.CmdLists[i];
+        ImDrawList *to = lists[i];
+        // ImVector assignment reuses the capacity of last frame's copy
+        to->CmdBuffer = from->CmdBuffer;
+        to->IdxBuffer = from->IdxBuffer;
+        to->VtxBuffer = from->VtxBuffer;
+        to->Flags = from->Flags;
+
+        // the texture data belongs to the atlas and may change after this frame, its GL name does not
+        for (ImDrawCmd &cmd : to->CmdBuffer)
+            cmd.TexRef = ImTextureRef(cmd.GetTexID());
+
+        data.CmdLists.push_back(to);
+    }
+
+    data.Valid = true;
+    data.CmdListsCount = source.CmdListsCount;
+    data.TotalIdxCount = source.TotalIdxCount;
+    data.TotalVtxCount = source.TotalVtxCount;
+    data.DisplayPos = source.DisplayPos;
+    data.DisplaySize = source.DisplaySize;
+    data.FramebufferScale = source.FramebufferScale;
+    // texture updates already happened, the backend must not look for more
+    data.Textures = nullptr;
+}
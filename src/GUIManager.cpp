@@ -1,5 +1,7 @@
 #include "GUI.h"
 #include "glm/gtc/type_ptr.hpp"
+#include "GLState.h"
+#include "RenderThread.h"
 
 #include <windows.h>
 #include <psapi.h>
@@ -35,6 +37,7 @@ namespace
     constexpr float CONSOLE_HEIGHT = 320.0f;
 
     // --- Forward declarations for static helper functions ---
+    bool InspectTransform(SceneManager *scene, Node *selectedNode);
     void InspectModelNode(SceneManager *scene, Node *selectedNode);
     void InspectLightNode(SceneManager *scene, Node *selectedNode);
     void InspectParticleEmitterNode(SceneManager *scene, Node *particleNode);
@@ -105,7 +108,7 @@ void RestoreOutput()
 }
 
 static void DrawConsolePanel(int windowWidth, int windowHeight);
-static void DrawResourceOverlay();
+static void DrawResourceOverlay(SceneManager *scene);
 
 // ===================================================================================
 // ========================= GUIManager CLASS IMPLEMENTATION =========================
@@ -120,7 +123,6 @@ GUIManager::GUIManager(GLFWwindow *window, SceneManager &sceneRef, int w, int h)
 
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
     io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
-    io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;
 
     // VISUAL IMPROVEMENT: Apply a more professional custom dark theme
     ImGui::StyleColorsDark();
@@ -158,6 +160,8 @@ GUIManager::GUIManager(GLFWwindow *window, SceneManager &sceneRef, int w, int h)
 
     ImGui_ImplGlfw_InitForOpenGL(window, false);
     ImGui_ImplOpenGL3_Init();
+    // NewFrame() would create these on first use, it must not touch GL on the update thread
+    ImGui_ImplOpenGL3_CreateDeviceObjects();
 
     RedirectOutputToConsoleBuffer();
     std::cout << "[GUIManager] Initialized." << std::endl;
@@ -172,19 +176,33 @@ void GUIManager::Start()
     DrawSidePanel(windowWidth, windowHeight);
     DrawConsolePanel(windowWidth, windowHeight);
     DrawAddNodeModal();
-    DrawResourceOverlay();
+    DrawResourceOverlay(scene);
 }
 
-void GUIManager::Render()
+void GUIManager::EndFrame(GUIDrawData &out)
 {
     ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    ImDrawData *drawData = ImGui::GetDrawData();
+
+    // font atlas uploads are the only GL work of the UI, done before the copy picks up texture names
+    bool texturesChanged = false;
+    if (drawData->Textures)
+        for (ImTextureData *texture : *drawData->Textures)
+            texturesChanged |= texture->Status != ImTextureStatus_OK;
+    if (texturesChanged)
+        scene->withContext([drawData]
+                           {
+            for (ImTextureData *texture : *drawData->Textures)
+                if (texture->Status != ImTextureStatus_OK)
+                    ImGui_ImplOpenGL3_UpdateTexture(texture); });
+
+    out.copy(*drawData);
+}
 
-    if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
-    {
-        ImGui::UpdatePlatformWindows();
-        ImGui::RenderPlatformWindowsDefault();
-    }
+void GUIManager::Render(GUIDrawData &drawData)
+{
+    if (drawData.isValid())
+        ImGui_ImplOpenGL3_RenderDrawData(drawData.get());
 }
 
 void GUIManager::Shutdown()
@@ -298,16 +316,18 @@ void GUIManager::DrawAddNodeModal()
             std::string shaderNameStr(shaderNameInput);
 
             NodeType type = static_cast<NodeType>(selectedNodeType);
-            if (type == NodeType::Model)
-                scene->addToParent(nameStr, modelPathStr, type, parentNodeId);
-            else if (type == NodeType::Light)
-                scene->addToParent(nameStr, type, parentNodeId, static_cast<LightType>(selectedLightType));
-            else if (type == NodeType::Particles)
-                scene->addToParent(nameStr, type, parentNodeId, shaderNameStr, static_cast<unsigned int>(maxParticles));
-            else if (type == NodeType::RigidBody)
-                scene->addToParent(nameStr, type, parentNodeId, RigidBodyShape::CUBE, rigidBodyMass);
-            else
-                scene->addToParent(nameStr, type, parentNodeId);
+            scene->withContext([&]
+                               {
+                if (type == NodeType::Model)
+                    scene->addToParent(nameStr, modelPathStr, type, parentNodeId);
+                else if (type == NodeType::Light)
+                    scene->addToParent(nameStr, type, parentNodeId, static_cast<LightType>(selectedLightType));
+                else if (type == NodeType::Particles)
+                    scene->addToParent(nameStr, type, parentNodeId, shaderNameStr, static_cast<unsigned int>(maxParticles));
+                else if (type == NodeType::RigidBody)
+                    scene->addToParent(nameStr, type, parentNodeId, RigidBodyShape::CUBE, rigidBodyMass);
+                else
+                    scene->addToParent(nameStr, type, parentNodeId); });
 
             showAddNodeModal = false;
             ImGui::CloseCurrentPopup();
@@ -330,7 +350,7 @@ void GUIManager::DrawSceneNode(Node *node)
     ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanAvailWidth;
     if (selectedNodeID == node->ID)
         flags |= ImGuiTreeNodeFlags_Selected;
-    if (node->children.empty())
+    if (!node->hasChildren())
         flags |= ImGuiTreeNodeFlags_Leaf;
 
     const std::string name = node->name + " (ID: " + std::to_string(node->ID) + ")";
@@ -344,7 +364,7 @@ void GUIManager::DrawSceneNode(Node *node)
 
     if (open)
     {
-        for (Node *child : node->children)
+        for (Node *child = node->firstChild; child; child = child->nextSibling)
         {
             DrawSceneNode(child);
         }
@@ -375,6 +395,9 @@ void GUIManager::selectedItemInspector(Node *selectedNode)
     case NodeType::RigidBody:
         InspectRigidBodyNode(scene, selectedNode);
         break;
+    case NodeType::Empty:
+        InspectTransform(scene, selectedNode);
+        break;
     default:
         ImGui::TextDisabled("This node type has no editable properties.");
         break;
@@ -387,7 +410,8 @@ void GUIManager::selectedItemInspector(Node *selectedNode)
     if (ImGui::Button("Delete Node", ImVec2(-1, 0)))
     {
         std::cout << "Deleting node with ID: " << selectedNode->ID << std::endl;
-        scene->deleteNode(selectedNode->ID);
+        scene->withContext([&]
+                           { scene->deleteNode(selectedNode->ID); });
         selectedNodeID = -1;
     }
     ImGui::PopStyleColor(3);
@@ -420,31 +444,56 @@ namespace
         return 0.0f;
     }
 
-    void InspectModelNode(SceneManager *scene, Node *selectedNode)
+    bool InspectTransform(SceneManager *scene, Node *selectedNode)
     {
-        Model *model = scene->getModelByID(selectedNode->ID);
-        if (!model)
-            return;
-
-        ImGui::Text("Path: %s", model->directory.c_str());
+        TransformStore &transforms = scene->transforms;
 
         ImGui::Spacing();
         ImGui::Separator();
         ImGui::Text("Transform");
         ImGui::Spacing();
 
-        glm::vec3 position = model->getPosition();
-        glm::vec3 rotation = model->getRotation();
-        glm::vec3 scale = model->getScale();
+        glm::vec3 position = transforms.getPosition(selectedNode->ID);
+        glm::vec3 rotation = transforms.getRotation(selectedNode->ID);
+        glm::vec3 scale = transforms.getScale(selectedNode->ID);
 
+        bool changed = false;
         ImGui::PushItemWidth(-FLT_MIN * 0.5f); // Make drag floats take up half the width
         if (ImGui::DragFloat3("Position", glm::value_ptr(position), 0.01f))
-            model->setPosition(position);
+        {
+            transforms.setPosition(selectedNode->ID, position);
+            changed = true;
+        }
         if (ImGui::DragFloat3("Rotation", glm::value_ptr(rotation), 0.1f))
-            model->setRotation(rotation);
+        {
+            transforms.setRotation(selectedNode->ID, rotation);
+            changed = true;
+        }
         if (ImGui::DragFloat3("Scale", glm::value_ptr(scale), 0.01f))
-            model->setScale(scale);
+        {
+            transforms.setScale(selectedNode->ID, scale);
+            changed = true;
+        }
         ImGui::PopItemWidth();
+        return changed;
+    }
+
+    void InspectModelNode(SceneManager *scene, Node *selectedNode)
+    {
+        Model *model = scene->getModelByID(selectedNode->ID);
+        if (!model)
+            return;
+
+        ImGui::Text("Path: %s", model->directory.c_str());
+        if (model->getAsset()->state == AssetState::Loading)
+            ImGui::TextDisabled("Loading...");
+        else if (model->getAsset()->state == AssetState::Failed)
+            ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "Failed to load");
+
+        InspectTransform(scene, selectedNode);
+
+        if (!model->hasAnimation)
+            ImGui::Checkbox("Occluder", &model->occluder);
 
         if (model->hasAnimation)
         {
@@ -454,7 +503,7 @@ namespace
             ImGui::Spacing();
 
             Animator &animator = model->getAnimator();
-            Animation *currentAnim = animator.getCurrentAnimation();
+            const Animation *currentAnim = animator.getCurrentAnimation();
             if (currentAnim)
             {
                 const char *current_anim_name = animator.animationNames[animator.currentAnimationIndex].c_str();
@@ -485,27 +534,27 @@ namespace
         Light *light = scene->getLightByID(selectedNode->ID);
         if (!light)
             return;
-        ImGui::DragFloat3("Position", glm::value_ptr(light->position), 0.1f);
         ImGui::ColorEdit3("Color", glm::value_ptr(light->color));
+        if (light->type != LightType::DIRECTIONAL)
+            ImGui::DragFloat("Radius", &light->radius, 0.1f, 0.1f, 500.0f);
+        InspectTransform(scene, selectedNode);
     }
 
     void InspectParticleEmitterNode(SceneManager *scene, Node *particleNode)
     {
         ParticleEmitter *emitter = scene->getEmitterByID(particleNode->ID);
-        if (!emitter || particleNode->children.empty())
+        if (!emitter || !particleNode->hasChildren())
             return;
-        Light *light = scene->getLightByID(particleNode->children[0]->ID);
+        Light *light = scene->getLightByID(particleNode->firstChild->ID);
         if (!light)
             return;
 
-        if (ImGui::DragFloat3("Position", glm::value_ptr(emitter->Position), 0.1f))
-        {
-            light->position = emitter->Position;
-        }
+        // the emitter's light is a child node, so it follows the emitter's transform
         if (ImGui::ColorEdit4("Color", glm::value_ptr(emitter->Color)))
         {
             light->color = glm::vec3(emitter->Color);
         }
+        InspectTransform(scene, particleNode);
     }
 
     void InspectRigidBodyNode(SceneManager *scene, Node *rigidBodyNode)
@@ -514,36 +563,14 @@ namespace
         if (!body)
             return;
 
-        ImGui::Spacing();
-        ImGui::Separator();
-        ImGui::Text("Transform");
-        ImGui::Spacing();
+        // position/rotation go through the node transform and are pushed to bullet by SceneManager::Update
+        if (InspectTransform(scene, rigidBodyNode))
+            body->activate(true);
 
-        btTransform trans;
-        body->getMotionState()->getWorldTransform(trans);
-        glm::vec3 position(trans.getOrigin().x(), trans.getOrigin().y(), trans.getOrigin().z());
-        glm::quat rotationQuat(trans.getRotation().w(), trans.getRotation().x(), trans.getRotation().y(), trans.getRotation().z());
-        glm::vec3 eulerRotation = glm::degrees(glm::eulerAngles(rotationQuat));
         btVector3 scaleVec = body->getCollisionShape()->getLocalScaling();
         glm::vec3 scale(scaleVec.x(), scaleVec.y(), scaleVec.z());
 
-        bool transformChanged = false;
-        if (ImGui::DragFloat3("Position", glm::value_ptr(position), 0.01f))
-            transformChanged = true;
-        if (ImGui::DragFloat3("Rotation", glm::value_ptr(eulerRotation), 1.0f))
-            transformChanged = true;
-
-        if (transformChanged)
-        {
-            trans.setOrigin(btVector3(position.x, position.y, position.z));
-            glm::quat newRotQuat = glm::quat(glm::radians(eulerRotation));
-            trans.setRotation(btQuaternion(newRotQuat.x, newRotQuat.y, newRotQuat.z, newRotQuat.w));
-            body->setWorldTransform(trans);
-            body->getMotionState()->setWorldTransform(trans);
-            body->activate(true);
-        }
-
-        if (ImGui::DragFloat3("Scale", glm::value_ptr(scale), 0.01f, 0.1f))
+        if (ImGui::DragFloat3("Collider Scale", glm::value_ptr(scale), 0.01f, 0.1f))
         {
             body->getCollisionShape()->setLocalScaling(btVector3(scale.x, scale.y, scale.z));
             scene->physics->getDynamicsWorld()->updateSingleAabb(body);
@@ -600,7 +627,7 @@ static void DrawConsolePanel(int windowWidth, int windowHeight)
     ImGui::End();
 }
 
-static void DrawResourceOverlay()
+static void DrawResourceOverlay(SceneManager *scene)
 {
     ImGuiWindowFlags flags = ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
                              ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing |
@@ -629,6 +656,44 @@ static void DrawResourceOverlay()
         char ramLabel[32];
         snprintf(ramLabel, sizeof(ramLabel), "Sys RAM: %.1f%%", systemRamPercent * 100.0f);
         ImGui::ProgressBar(systemRamPercent, ImVec2(180, 0), ramLabel);
+        ImGui::Separator();
+        const TransformStats &transformStats = scene->transforms.getStats();
+        ImGui::Text("Transforms: %u updated / %u skipped", transformStats.recomputed, transformStats.skipped);
+        // drawn by the render side, this is its last finished frame
+        const FrameStats frameStats = scene->getFrameStats();
+        const RenderStats &sorted = frameStats.sorted;
+        const RenderStats &unsorted = frameStats.unsorted;
+        ImGui::Text("Draws: %u for %u instances (unsorted %u)", sorted.drawCalls, sorted.instances, unsorted.drawCalls);
+        ImGui::Text("Programs: %u (unsorted %u)", sorted.programSwitches, unsorted.programSwitches);
+        ImGui::Text("Texture binds: %u (unsorted %u)", sorted.textureBinds, unsorted.textureBinds);
+        ImGui::Text("VAO binds: %u (unsorted %u)", sorted.vertexArrayBinds, unsorted.vertexArrayBinds);
+        const CullStats &cullStats = scene->getCullStats();
+        ImGui::Checkbox("Frustum culling", &scene->frustumCulling);
+        ImGui::SameLine();
+        ImGui::Checkbox("Occlusion culling", &scene->occlusionCulling);
+        ImGui::Text("Meshes: %u visible / %u culled / %u occluded", cullStats.visible, cullStats.culled, cullStats.occluded);
+        if (scene->occlusionCulling)
+            ImGui::Text("Occluders: %zu triangles", scene->getOccluderTriangleCount());
+        ImGui::Text("Shading: %s", scene->deferredShading ? "deferred (G-buffer)" : "forward");
+        if (scene->sm && frameStats.compilingShaders > 0)
+            ImGui::Text("Shaders: %zu compiling %s", frameStats.compilingShaders, scene->sm->getCompileModeName());
+        if (scene->renderThread)
+            ImGui::Text("Render thread: update waited %.2f ms", scene->renderThread->getWaitMs());
+        if (const LightClusters *clusters = scene->getLightClusters())
+            ImGui::Text("Lights: %zu, %zu cluster entries (max %u per cluster)", clusters->getLightCount(), clusters->getIndexCount(), clusters->getMaxPerCluster());
+        ImGui::Text("Spatial tree: %zu objects, height %d", scene->spatial.size(), scene->spatial.getHeight());
+        ImGui::Text("Geometry arena: %zu / %zu vertices", scene->geometry.vertexUsed(), scene->geometry.vertexCapacity());
+        bool countState = frameStats.countingGLState;
+        if (ImGui::Checkbox("Count GL state calls", &countState))
+            scene->withContext([countState]
+                               { GLState::SetCounting(countState); });
+        if (countState)
+        {
+            const GLStateStats &stateStats = frameStats.glState;
+            ImGui::Text("GL state: %u issued / %u skipped", stateStats.issued, stateStats.skipped);
+        }
+        if (scene->assets.loadingCount() > 0)
+            ImGui::Text("Loading %u models...", scene->assets.loadingCount());
     }
     ImGui::End();
 }
@@ -0,0 +1,198 @@
+#include "GeometryArena.h"
+#include "GLState.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+
+namespace
+{
+    constexpr uint32_t INITIAL_VERTICES = 1 << 16;
+    constexpr uint32_t INITIAL_INDICES = 1 << 18;
+}
+
+GeometryArena::~GeometryArena()
+{
+    GLState::DeleteVertexArray(VAO);
+    GLState::DeleteBuffer(vertices.buffer);
+    GLState::DeleteBuffer(indices.buffer);
+}
+
+bool GeometryArena::Region::allocate(uint32_t size, uint32_t &offset)
+{
+    if (size == 0)
+    {
+        offset = 0;
+        return true;
+    }
+    for (size_t i = 0; i < free.size(); i++)
+    {
+        if (free[i].size < size)
+            continue;
+        offset = free[i].offset;
+        free[i].offset += size;
+        free[i].size -= size;
+        if (free[i].size == 0)
+            free.erase(free.begin() + i);
+        used += size;
+        return true;
+    }
+    return false;
+}
+
+void GeometryArena::Region::release(uint32_t offset, uint32_t size)
+{
+    used -= size;
+    auto it = std::lower_bound(free.begin(), free.end(), offset,
+                               [](const Block &block, uint32_t value)
+                               { return block.offset < value; });
+    it = free.insert(it, {offset, size});
+
+    // merge with the following block, then with the preceding one
+    auto next = it + 1;
+    if (next != free.end() && it->offset + it->size == next->offset)
+    {
+        it->size += next->size;
+        free.erase(next);
+    }
+    if (it != free.begin())
+    {
+        auto prev = it - 1;
+        if (prev->offset + prev->size == it->offset)
+        {
+            prev->size += it->size;
+            free.erase(it);
+        }
+    }
+}
+
+void GeometryArena::Region::grow(uint32_t newCapacity)
+{
+    // the new tail is free, joined with a free block that ended at the old capacity
+    if (!free.empty() && free.back().offset + free.back().size == capacity)
+        free.back().size += newCapacity - capacity;
+    else
+        free.push_back({capacity, newCapacity - capacity});
+    capacity = newCapacity;
+}
+
+bool GeometryArena::reserve(Region &region, GLenum target, size_t elementSize, uint32_t size)
+{
+    // first-fit needs one block of size, which can only be the free block ending at
+    // the old capacity joined with the new tail
+    uint64_t trailingFree = 0;
+    if (!region.free.empty() && region.free.back().offset + region.free.back().size == region.capacity)
+        trailingFree = region.free.back().size;
+
+    uint64_t newCapacity = std::max<uint64_t>(region.capacity * 2ull, target == GL_ARRAY_BUFFER ? INITIAL_VERTICES : INITIAL_INDICES);
+    while (newCapacity - region.capacity + trailingFree < size)
+        newCapacity *= 2;
+    if (newCapacity > UINT32_MAX)
+        return false;
+
+    unsigned int buffer;
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, newCapacity * elementSize, nullptr, GL_STATIC_DRAW);
+
+    if (region.buffer)
+    {
+        glBindBuffer(GL_COPY_READ_BUFFER, region.buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, region.capacity * elementSize);
+        GLState::DeleteBuffer(region.buffer);
+        std::cout << "[GeometryArena] Grew " << (target == GL_ARRAY_BUFFER ? "vertex" : "index")
+                  << " buffer to " << newCapacity << " elements" << std::endl;
+    }
+
+    region.buffer = buffer;
+    region.grow(static_cast<uint32_t>(newCapacity));
+    return true;
+}
+
+unsigned int GeometryArena::getVAO()
+{
+    if (!VAO)
+    {
+        glGenVertexArrays(1, &VAO);
+        reserve(vertices, GL_ARRAY_BUFFER, sizeof(Vertex), 0);
+        reserve(indices, GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t), 0);
+        attachBuffers();
+    }
+    return VAO;
+}
+
+void GeometryArena::attachBuffers()
+{
+    GLState::BindVertexArray(VAO);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, vertices.buffer);
+    GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, indices.buffer);
+
+    // same layout as Mesh
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, normal));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, texCoords));
+    glEnableVertexAttribArray(3);
+    glVertexAttribIPointer(3, 4, GL_INT, sizeof(Vertex), (void *)offsetof(Vertex, boneIds));
+    glEnableVertexAttribArray(4);
+    glVertexAttribPointer(4, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, boneWeights));
+
+    GLState::BindVertexArray(0);
+}
+
+bool GeometryArena::Allocate(const Vertex *vertexData, size_t vertexCount, const unsigned int *indexData, size_t indexCount, GeometryRange &range)
+{
+    getVAO();
+
+    if (vertexCount > UINT32_MAX || indexCount > UINT32_MAX)
+        return false;
+    range.vertexCount = static_cast<uint32_t>(vertexCount);
+    range.indexCount = static_cast<uint32_t>(indexCount);
+
+    bool regrown = false;
+    if (!vertices.allocate(range.vertexCount, range.baseVertex))
+    {
+        if (!reserve(vertices, GL_ARRAY_BUFFER, sizeof(Vertex), range.vertexCount) ||
+            !vertices.allocate(range.vertexCount, range.baseVertex))
+        {
+            std::cerr << "[GeometryArena - ERROR] No room for " << vertexCount << " vertices" << std::endl;
+            return false;
+        }
+        regrown = true;
+    }
+    if (!indices.allocate(range.indexCount, range.firstIndex))
+    {
+        if (!reserve(indices, GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t), range.indexCount) ||
+            !indices.allocate(range.indexCount, range.firstIndex))
+        {
+            std::cerr << "[GeometryArena - ERROR] No room for " << indexCount << " indices" << std::endl;
+            if (range.vertexCount)
+                vertices.release(range.baseVertex, range.vertexCount);
+            if (regrown)
+                attachBuffers();
+            return false;
+        }
+        regrown = true;
+    }
+    if (regrown)
+        attachBuffers();
+
+    GLState::BindBuffer(GL_ARRAY_BUFFER, vertices.buffer);
+    glBufferSubData(GL_ARRAY_BUFFER, range.baseVertex * sizeof(Vertex), vertexCount * sizeof(Vertex), vertexData);
+
+    // the element binding is VAO state, upload through the copy target instead
+    glBindBuffer(GL_COPY_WRITE_BUFFER, indices.buffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, range.firstIndex * sizeof(uint32_t), indexCount * sizeof(uint32_t), indexData);
+
+    return true;
+}
+
+void GeometryArena::Free(const GeometryRange &range)
+{
+    if (range.vertexCount)
+        vertices.release(range.baseVertex, range.vertexCount);
+    if (range.indexCount)
+        indices.release(range.firstIndex, range.indexCount);
+}
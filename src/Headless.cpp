@@ -0,0 +1,114 @@
+#include "Headless.h"
+
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+
+#include <json.hpp>
+
+using json = nlohmann::json;
+
+bool HeadlessOptions::parse(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--headless")
+        {
+            enabled = true;
+            continue;
+        }
+
+        bool hasValue = i + 1 < argc;
+        try
+        {
+            if (arg == "--frames" && hasValue)
+                frames = std::stoi(argv[++i]);
+            else if (arg == "--timestep" && hasValue)
+                timestep = std::stof(argv[++i]);
+            else if (arg == "--timings" && hasValue)
+                timingsPath = argv[++i];
+            else if (arg == "--dump-frames" && hasValue)
+                dumpDirectory = argv[++i];
+            else if (arg == "--size" && hasValue)
+            {
+                std::string size = argv[++i];
+                size_t x = size.find('x');
+                if (x == std::string::npos)
+                    throw std::invalid_argument(size);
+                width = std::stoi(size.substr(0, x));
+                height = std::stoi(size.substr(x + 1));
+            }
+        }
+        catch (const std::exception &)
+        {
+            std::cerr << "[Headless] Bad value for " << arg << ": " << argv[i] << std::endl;
+            return false;
+        }
+    }
+
+    if (frames <= 0 || width <= 0 || height <= 0 || timestep <= 0.0f)
+    {
+        std::cerr << "[Headless] --frames, --size and --timestep must be positive." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+namespace
+{
+    json summarize(std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+        double sum = 0.0;
+        for (double value : values)
+            sum += value;
+
+        auto percentile = [&](double p)
+        { return values[std::min(values.size() - 1, static_cast<size_t>(p * (values.size() - 1) + 0.5))]; };
+
+        return {{"mean", sum / values.size()},
+                {"median", percentile(0.5)},
+                {"p95", percentile(0.95)},
+                {"max", values.back()}};
+    }
+}
+
+bool TimingLog::write(const std::string &path, const HeadlessOptions &options, const std::string &scenePath, bool renderThread, bool deferred) const
+{
+    json out;
+    out["scene"] = scenePath;
+    out["width"] = options.width;
+    out["height"] = options.height;
+    out["timestep"] = options.timestep;
+    out["renderThread"] = renderThread;
+    out["deferred"] = deferred;
+
+    json perFrame = json::array();
+    std::vector<double> update, wait, render, frame;
+    for (const FrameTiming &timing : frames)
+    {
+        perFrame.push_back({{"updateMs", timing.updateMs},
+                            {"waitMs", timing.waitMs},
+                            {"renderMs", timing.renderMs},
+                            {"frameMs", timing.frameMs}});
+        update.push_back(timing.updateMs);
+        wait.push_back(timing.waitMs);
+        render.push_back(timing.renderMs);
+        frame.push_back(timing.frameMs);
+    }
+    out["frames"] = perFrame;
+    out["summary"] = {{"updateMs", summarize(update)},
+                      {"waitMs", summarize(wait)},
+                      {"renderMs", summarize(render)},
+                      {"frameMs", summarize(frame)}};
+
+    std::ofstream file(path, std::ios::trunc);
+    if (!(file << out.dump(2) << std::endl))
+    {
+        std::cerr << "[Headless] Could not write " << path << std::endl;
+        return false;
+    }
+    std::cout << "[Headless] " << frames.size() << " frame timings written to " << path << std::endl;
+    return true;
+}
@@ -0,0 +1,121 @@
+#include "JobSystem.h"
+
+#include <iostream>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+
+JobSystem::JobSystem(unsigned int workerCount)
+{
+    if (workerCount == 0)
+    {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        workerCount = hardware > 1 ? hardware - 1 : 1;
+    }
+
+    workers.reserve(workerCount);
+    for (unsigned int i = 0; i < workerCount; i++)
+        workers.emplace_back(&JobSystem::workerLoop, this);
+
+    std::cout << "[JobSystem] Started " << workerCount << " worker threads." << std::endl;
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    jobAvailable.notify_all();
+
+    // whatever is still queued runs before the workers exit
+    for (std::thread &worker : workers)
+        worker.join();
+}
+
+void JobSystem::submit(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    jobAvailable.notify_one();
+}
+
+void JobSystem::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    allDone.wait(lock, [this]
+                 { return jobs.empty() && running == 0; });
+}
+
+void JobSystem::parallelFor(unsigned int count, const std::function<void(unsigned int)> &body)
+{
+    if (count == 0)
+        return;
+
+    // outlives the call, helpers that only get scheduled afterwards find nothing left and leave
+    struct Batch
+    {
+        std::atomic<unsigned int> next{0};
+        std::atomic<unsigned int> done{0};
+        unsigned int count = 0;
+        const std::function<void(unsigned int)> *body = nullptr;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    std::shared_ptr<Batch> batch = std::make_shared<Batch>();
+    batch->count = count;
+    batch->body = &body;
+
+    auto work = [batch]
+    {
+        unsigned int index;
+        while ((index = batch->next.fetch_add(1)) < batch->count)
+        {
+            (*batch->body)(index);
+            if (batch->done.fetch_add(1) + 1 == batch->count)
+            {
+                std::lock_guard<std::mutex> lock(batch->mutex);
+                batch->finished.notify_all();
+            }
+        }
+    };
+
+    unsigned int helpers = std::min<unsigned int>(count - 1, getWorkerCount());
+    for (unsigned int i = 0; i < helpers; i++)
+        submit(work);
+    work();
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->finished.wait(lock, [&]
+                         { return batch->done.load() == batch->count; });
+}
+
+void JobSystem::workerLoop()
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this]
+                              { return stopping || !jobs.empty(); });
+            if (jobs.empty())
+                return;
+
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            running++;
+        }
+
+        job();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running--;
+            if (jobs.empty() && running == 0)
+                allDone.notify_all();
+        }
+    }
+}
@@ -1,18 +1,15 @@
 #include "Light.h"
 
 Light::Light(unsigned int id, LightType type)
-    : ID(id), type(type), lightMesh(Mesh(MeshType::CUBE))
+    : ID(id), type(type)
 {
     std::cout << "[Lights] Created a Light with ID: " << ID << " and type: " << (unsigned int)type << std::endl;
 }
 
-void Light::Draw(Shader &lightShader)
+glm::mat4 Light::getGizmoMatrix(const glm::vec3 &worldPosition) const
 {
     glm::mat4 model = glm::mat4(1.f);
-    model = glm::translate(model, this->position);
+    model = glm::translate(model, worldPosition);
     model = glm::scale(model, glm::vec3(.3f));
-
-    lightShader.setUniforms("uLightColor", static_cast<unsigned int>(UniformType::Vec3f), (void *)(glm::value_ptr(this->color)));
-    lightShader.setUniforms("model", static_cast<unsigned int>(UniformType::Mat4f), (void *)(glm::value_ptr(model)));
-    lightMesh.Draw(lightShader);
+    return model;
 }
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "LightClusters.h"
+#include "GLState.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+LightClusters::~LightClusters()
+{
+    for (unsigned int texture : textures)
+        GLState::DeleteTexture(texture);
+}
+
+float LightClusters::sliceDepth(int slice) const
+{
+    return nearPlane * std::pow(farPlane / nearPlane, static_cast<float>(slice) / SLICES);
+}
+
+void LightClusters::Build(const std::vector<ClusterLight> &lights, const glm::mat4 &view, const glm::mat4 &projectionMatrix, JobSystem &jobs)
+{
+    ordered.clear();
+    for (const ClusterLight &light : lights)
+        if (light.global)
+            ordered.push_back(light);
+    globalCount = static_cast<int>(ordered.size());
+    for (const ClusterLight &light : lights)
+        if (!light.global)
+            ordered.push_back(light);
+
+    viewSpheres.resize(ordered.size());
+    for (size_t i = globalCount; i < ordered.size(); i++)
+        viewSpheres[i] = glm::vec4(glm::vec3(view * glm::vec4(ordered[i].position, 1.0f)), ordered[i].radius);
+
+    // near and far back out of a perspective matrix
+    projection = projectionMatrix;
+    float a = projection[2][2], b = projection[3][2];
+    float n = b / (a - 1.0f), f = b / (a + 1.0f);
+    if (n > 0.0f && f > n)
+    {
+        nearPlane = n;
+        farPlane = f;
+    }
+
+    slices.resize(SLICES);
+    jobs.parallelFor(SLICES, [this](unsigned int slice)
+                     { buildSlice(static_cast<int>(slice)); });
+
+    indexCount = 0;
+    maxPerCluster = 0;
+    for (const Slice &slice : slices)
+    {
+        indexCount += slice.indices.size();
+        for (const glm::uvec2 &range : slice.ranges)
+            maxPerCluster = std::max(maxPerCluster, range.y);
+    }
+}
+
+void LightClusters::buildSlice(int slice)
+{
+    Slice &out = slices[slice];
+    out.indices.clear();
+    out.ranges.assign(TILES_X * TILES_Y, glm::uvec2(0));
+
+    const float d0 = sliceDepth(slice), d1 = sliceDepth(slice + 1);
+    const float p00 = projection[0][0], p11 = projection[1][1];
+    const float p20 = projection[2][0], p21 = projection[2][1];
+
+    // screen tile rectangle of every light reaching into this slice, from the corners of its
+    // box clipped to the slice depth (ndc.x = p00 * x / depth - p20 is monotonic in both)
+    struct Candidate
+    {
+        uint32_t light;
+        int x0, x1, y0, y1;
+    };
+    std::vector<Candidate> candidates;
+
+    for (size_t i = globalCount; i < ordered.size(); i++)
+    {
+        const glm::vec4 &sphere = viewSpheres[i];
+        float depth = -sphere.z, radius = sphere.w;
+        if (depth + radius < d0 || depth - radius > d1)
+            continue;
+        float nearDepth = std::max(d0, depth - radius), farDepth = std::min(d1, depth + radius);
+
+        float minX = 1e30f, maxX = -1e30f, minY = 1e30f, maxY = -1e30f;
+        for (float d : {nearDepth, farDepth})
+        {
+            for (float x : {sphere.x - radius, sphere.x + radius})
+            {
+                float ndc = p00 * x / d - p20;
+                minX = std::min(minX, ndc);
+                maxX = std::max(maxX, ndc);
+            }
+            for (float y : {sphere.y - radius, sphere.y + radius})
+            {
+                float ndc = p11 * y / d - p21;
+                minY = std::min(minY, ndc);
+                maxY = std::max(maxY, ndc);
+            }
+        }
+        if (maxX < -1.0f || minX > 1.0f || maxY < -1.0f || minY > 1.0f)
+            continue;
+
+        auto tile = [](float ndc, int count)
+        { return std::clamp(static_cast<int>((ndc * 0.5f + 0.5f) * count), 0, count - 1); };
+        candidates.push_back({static_cast<uint32_t>(i), tile(minX, TILES_X), tile(maxX, TILES_X), tile(minY, TILES_Y), tile(maxY, TILES_Y)});
+    }
+
+    for (int ty = 0; ty < TILES_Y; ty++)
+    {
+        // view space box of the froxel row/column, widest at the far end of the slice
+        float ny0 = ty * 2.0f / TILES_Y - 1.0f, ny1 = (ty + 1) * 2.0f / TILES_Y - 1.0f;
+        float minY = std::min((ny0 + p21) * d0, (ny0 + p21) * d1) / p11;
+        float maxY = std::max((ny1 + p21) * d0, (ny1 + p21) * d1) / p11;
+
+        for (int tx = 0; tx < TILES_X; tx++)
+        {
+            float nx0 = tx * 2.0f / TILES_X - 1.0f, nx1 = (tx + 1) * 2.0f / TILES_X - 1.0f;
+            float minX = std::min((nx0 + p20) * d0, (nx0 + p20) * d1) / p00;
+            float maxX = std::max((nx1 + p20) * d0, (nx1 + p20) * d1) / p00;
+            glm::vec3 boxMin(minX, minY, -d1), boxMax(maxX, maxY, -d0);
+
+            glm::uvec2 &range = out.ranges[ty * TILES_X + tx];
+            range.x = static_cast<uint32_t>(out.indices.size());
+
+            for (const Candidate &candidate : candidates)
+            {
+                if (tx < candidate.x0 || tx > candidate.x1 || ty < candidate.y0 || ty > candidate.y1)
+                    continue;
+
+                const glm::vec4 &sphere = viewSpheres[candidate.light];
+                glm::vec3 closest = glm::clamp(glm::vec3(sphere), boxMin, boxMax);
+                glm::vec3 d = closest - glm::vec3(sphere);
+                if (glm::dot(d, d) > sphere.w * sphere.w)
+                    continue;
+
+                out.indices.push_back(candidate.light);
+                if (++range.y == MAX_LIGHTS_PER_CLUSTER)
+                    break;
+            }
+        }
+    }
+}
+
+void LightClusters::Upload(StreamBuffer &stream, LightData &block)
+{
+    block = {};
+
+    // one list at a time, without buffer storage only one allocation may be mapped.
+    // a failed one leaves an all zero block, which lights nothing but beats reading stale lists
+    StreamAllocation lightAlloc = stream.Allocate(std::max<size_t>(ordered.size(), 1) * 2 * sizeof(glm::vec4), sizeof(glm::vec4));
+    if (!lightAlloc)
+        return;
+    glm::vec4 *lightTexels = static_cast<glm::vec4 *>(lightAlloc.data);
+    for (const ClusterLight &light : ordered)
+    {
+        *lightTexels++ = glm::vec4(light.position, light.radius);
+        *lightTexels++ = glm::vec4(light.color, 0.0f);
+    }
+    stream.Commit(lightAlloc);
+
+    // froxel (x, y, slice) lives at (slice * TILES_Y + y) * TILES_X + x, offsets become global
+    StreamAllocation rangeAlloc = stream.Allocate(CLUSTER_COUNT * sizeof(glm::uvec2), sizeof(glm::uvec2));
+    if (!rangeAlloc)
+        return;
+    glm::uvec2 *ranges = static_cast<glm::uvec2 *>(rangeAlloc.data);
+    uint32_t base = 0;
+    for (const Slice &slice : slices)
+    {
+        for (const glm::uvec2 &range : slice.ranges)
+            *ranges++ = glm::uvec2(range.x + base, range.y);
+        base += static_cast<uint32_t>(slice.indices.size());
+    }
+    stream.Commit(rangeAlloc);
+
+    StreamAllocation indexAlloc = stream.Allocate(std::max<size_t>(indexCount, 1) * sizeof(uint32_t), sizeof(uint32_t));
+    if (!indexAlloc)
+        return;
+    uint32_t *indices = static_cast<uint32_t *>(indexAlloc.data);
+    for (const Slice &slice : slices)
+    {
+        std::memcpy(indices, slice.indices.data(), slice.indices.size() * sizeof(uint32_t));
+        indices += slice.indices.size();
+    }
+    stream.Commit(indexAlloc);
+
+    // same trick as the bone palette, the textures view the whole stream buffer
+    if (!textures[0])
+        glGenTextures(3, textures);
+    if (attachedBuffer != lightAlloc.buffer)
+    {
+        const unsigned int units[3] = {LIGHT_DATA_UNIT, CLUSTER_RANGE_UNIT, LIGHT_INDEX_UNIT};
+        const GLenum formats[3] = {GL_RGBA32F, GL_RG32UI, GL_R32UI};
+        for (int i = 0; i < 3; i++)
+        {
+            GLState::BindTexture(units[i], GL_TEXTURE_BUFFER, textures[i]);
+            glTexBuffer(GL_TEXTURE_BUFFER, formats[i], lightAlloc.buffer);
+        }
+        attachedBuffer = lightAlloc.buffer;
+    }
+
+    float logRatio = std::log(farPlane / nearPlane);
+    block.clusterGrid = glm::ivec4(TILES_X, TILES_Y, SLICES, globalCount);
+    block.clusterDepth = glm::vec4(SLICES / logRatio, -SLICES * std::log(nearPlane) / logRatio, 0.0f, 0.0f);
+    block.texelBase = glm::ivec4(lightAlloc.offset / sizeof(glm::vec4), rangeAlloc.offset / sizeof(glm::uvec2),
+                                 indexAlloc.offset / sizeof(uint32_t), static_cast<int>(ordered.size()));
+}
+
+void LightClusters::Bind()
+{
+    GLState::BindTexture(LIGHT_DATA_UNIT, GL_TEXTURE_BUFFER, textures[0]);
+    GLState::BindTexture(CLUSTER_RANGE_UNIT, GL_TEXTURE_BUFFER, textures[1]);
+    GLState::BindTexture(LIGHT_INDEX_UNIT, GL_TEXTURE_BUFFER, textures[2]);
+}
@@ -1,4 +1,5 @@
 #include "Mesh.h"
+#include "GLState.h"
 
 float cubeVert[] = {
     -0.5f, -0.5f, -0.5f, 0.0f, 0.0f,
@@ -38,12 +39,31 @@ float cubeVert[] = {
     -0.5f, 0.5f, 0.5f, 0.0f, 0.0f,
     -0.5f, 0.5f, -0.5f, 0.0f, 1.0f};
 
-Mesh::Mesh(std::vector<Vertex> vert, std::vector<unsigned int> inds, std::vector<Texture> texs)
-    : vertices(vert), indices(inds), textures(texs),
-      VBO(vertices.data(), vertices.size() * sizeof(Vertex)),
-      EBO(indices.data(), indices.size() * sizeof(unsigned int))
+Mesh::Mesh(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount, std::vector<Texture> texs)
+    : indexCount(indexCount), textures(std::move(texs))
 {
-    VAO = VertexArray();
+    for (unsigned int i = 0; i < textures.size(); i++)
+    {
+        samplerNames.push_back(textures[i].type + std::to_string(i));
+        if (samplerNames.back() == "texture_diffuse0")
+            shaderFeatures |= SHADER_TEXTURED;
+    }
+
+    createBuffers(vertices, vertexCount, indices, indexCount);
+
+    AABB box;
+    for (size_t i = 0; i < vertexCount; i++)
+        box.expand(vertices[i].postition);
+    setBounds(box);
+
+    // std::cout << "[Mesh] Texture count : " << textures.size() << std::endl;
+}
+
+void Mesh::createBuffers(const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount)
+{
+    VBO = VertexBuffer(vertices, vertexCount * sizeof(Vertex));
+    EBO = ElementBuffer(indices, indexCount * sizeof(unsigned int));
+
     VAO.Bind();
     VBO.Bind();
     EBO.Bind();
@@ -60,13 +80,30 @@ Mesh::Mesh(std::vector<Vertex> vert, std::vector<unsigned int> inds, std::vector
     VAO.UnBind();
     VBO.UnBind();
     EBO.UnBind();
+}
 
-    // std::cout << "[Mesh] Texture count : " << textures.size() << std::endl;
+Mesh::Mesh(GeometryArena &arena, const Vertex *vertices, size_t vertexCount, const unsigned int *indices, size_t indexCount, std::vector<Texture> texs)
+    : indexCount(indexCount), textures(std::move(texs)), VAO(arena.getVAO()), arena(&arena)
+{
+    for (unsigned int i = 0; i < textures.size(); i++)
+    {
+        samplerNames.push_back(textures[i].type + std::to_string(i));
+        if (samplerNames.back() == "texture_diffuse0")
+            shaderFeatures |= SHADER_TEXTURED;
+    }
+
+    // a mesh the arena cannot take gets buffers of its own
+    if (!arena.Allocate(vertices, vertexCount, indices, indexCount, range))
+    {
+        this->arena = nullptr;
+        range = {};
+        VAO = VertexArray();
+        createBuffers(vertices, vertexCount, indices, indexCount);
+    }
 }
 
 Mesh::Mesh(MeshType type) : VBO(VertexBuffer(cubeVert, sizeof(cubeVert))), EBO(ElementBuffer(this->cubeIndices, sizeof(this->cubeIndices)))
 {
-    indices.push_back(0);
     if (type == MeshType::CUBE)
     {
         VAO = VertexArray();
@@ -80,34 +117,52 @@ Mesh::Mesh(MeshType type) : VBO(VertexBuffer(cubeVert, sizeof(cubeVert))), EBO(E
         VAO.UnBind();
         VBO.UnBind();
         EBO.UnBind();
+
+        setBounds({glm::vec3(-0.5f), glm::vec3(0.5f)});
     }
 }
 
+void Mesh::setBounds(const AABB &box)
+{
+    bounds = box;
+    sphere = BoundingSphere::fromAABB(box);
+}
+
 void Mesh::Draw(Shader &shader)
 {
-    // bind textures, and will also update required shader uniforms.
+    // everything goes through GLState, so rebinding what the last mesh left bound is free
     shader.use();
 
     for (unsigned int i = 0; i < textures.size(); i++)
     {
         textures[i].Bind(i);
-        textures[i].SetUniform(shader, textures[i].type + std::to_string(i));
+        textures[i].SetUniform(shader, samplerNames[i]);
     }
 
+    // the VAO carries the vertex layout and the element buffer
     VAO.Bind();
-    VBO.Bind();
-    EBO.Bind();
-    if (indices.size() > 1)
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+    if (arena)
+        glDrawElementsBaseVertex(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, (void *)(range.firstIndex * sizeof(unsigned int)), range.baseVertex);
+    else if (indexCount > 0)
+        glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
     else
     {
         glDrawArrays(GL_TRIANGLES, 0, 36);
         // std::cout << "[Mesh] Warning drawing without indexing. Vertex redundancy!" << std::endl;
     }
-    VAO.UnBind();
-    VBO.UnBind();
-    EBO.UnBind();
+}
 
-    for (unsigned int i = 0; i < textures.size(); i++)
-        textures[i].UnBind();
-}
\ No newline at end of file
+void Mesh::Release()
+{
+    if (arena)
+    {
+        arena->Free(range);
+        arena = nullptr;
+        VAO.ID = 0;
+        return;
+    }
+    GLState::DeleteVertexArray(VAO.ID);
+    GLState::DeleteBuffer(VBO.ID);
+    GLState::DeleteBuffer(EBO.ID);
+    VAO.ID = VBO.ID = EBO.ID = 0;
+}
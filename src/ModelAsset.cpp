@@ -0,0 +1,30 @@
+#include "ModelAsset.h"
+#include "ModelImporter.h"
+#include "FMesh.h"
+
+ModelAsset::ModelAsset(const std::string &path) : path(path)
+{
+}
+
+ModelAsset::~ModelAsset()
+{
+    // textures belong to the cache, only the geometry is ours
+    for (Mesh &mesh : meshes)
+        mesh.Release();
+}
+
+bool ModelAsset::loadData(const std::string &path, ModelData &data)
+{
+    const std::string cooked = FMesh::cookedPath(path);
+    if (FMesh::read(cooked, path, data))
+        return true;
+
+    data = ModelData();
+    ModelImporter importer;
+    if (!importer.import(path, data))
+        return false;
+
+    // next launch skips Assimp, a failed cook only costs us that
+    FMesh::write(cooked, path, data);
+    return true;
+}
@@ -0,0 +1,285 @@
+#include "ModelImporter.h"
+
+#include <iostream>
+
+bool ModelImporter::import(const std::string &path, ModelData &output)
+{
+    Assimp::Importer importer;
+    const aiScene *scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+
+    if (scene == nullptr)
+    {
+        std::cerr << "[ModelImporter - ERROR] Error loading model: " << importer.GetErrorString() << std::endl;
+        return false;
+    }
+
+    data = &output;
+
+    data->globalInverseTransform = assimpToGlmMatrix(scene->mRootNode->mTransformation);
+    data->globalInverseTransform = glm::inverse(data->globalInverseTransform);
+
+    processNode(scene->mRootNode, scene);
+
+    if (scene->HasAnimations())
+    {
+        data->hasAnimation = true;
+        loadAnimations(scene);
+        inflateSkinnedBounds();
+    }
+
+    data = nullptr;
+    return true;
+}
+
+void ModelImporter::processNode(aiNode *node, const aiScene *scene)
+{
+    for (unsigned int i = 0; i < node->mNumMeshes; i++)
+    {
+        unsigned int meshIndex = node->mMeshes[i];
+        aiMesh *mesh = scene->mMeshes[meshIndex];
+        processMesh(mesh, scene);
+    }
+
+    for (unsigned int i = 0; i < node->mNumChildren; i++)
+    {
+        processNode(node->mChildren[i], scene);
+    }
+}
+
+void ModelImporter::processMesh(aiMesh *mesh, const aiScene *scene)
+{
+    // sized up front and filled in place, this runs for every vertex of every mesh
+    std::vector<Vertex> vertices(mesh->mNumVertices);
+    std::vector<uint32_t> indices;
+    indices.reserve(mesh->mNumFaces * 3);
+    MeshData meshData;
+
+    for (unsigned int i = 0; i < mesh->mNumVertices; i++)
+    {
+        Vertex &vertex = vertices[i];
+        vertex.postition = glm::vec3(mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z);
+
+        if (mesh->HasNormals())
+        {
+            vertex.normal = glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z);
+        }
+        else
+            vertex.normal = glm::vec3(0.0f);
+
+        if (mesh->mTextureCoords[0])
+        {
+            vertex.texCoords = glm::vec2(mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y);
+        }
+        else
+            vertex.texCoords = glm::vec2(0.0f, 0.0f);
+    }
+
+    Skeleton &skeleton = data->skeleton;
+    std::unordered_map<std::string, std::pair<int, glm::mat4>> boneInfo = {};
+    std::vector<int> boneCounts;
+    boneCounts.resize(vertices.size(), 0);
+
+    if (mesh->HasBones())
+    {
+        skeleton.boneCount = mesh->mNumBones;
+
+        for (unsigned int i = 0; i < skeleton.boneCount; i++)
+        {
+            aiBone *bone = mesh->mBones[i];
+            glm::mat4 m = assimpToGlmMatrix(bone->mOffsetMatrix);
+            boneInfo[bone->mName.C_Str()] = {i, m};
+
+            for (unsigned int j = 0; j < bone->mNumWeights; j++)
+            {
+                unsigned int id = bone->mWeights[j].mVertexId;
+                float weight = bone->mWeights[j].mWeight;
+                boneCounts[id]++;
+                switch (boneCounts[id])
+                {
+                case 1:
+                    vertices[id].boneIds.x = i;
+                    vertices[id].boneWeights.x = weight;
+                    break;
+                case 2:
+                    vertices[id].boneIds.y = i;
+                    vertices[id].boneWeights.y = weight;
+                    break;
+                case 3:
+                    vertices[id].boneIds.z = i;
+                    vertices[id].boneWeights.z = weight;
+                    break;
+                case 4:
+                    vertices[id].boneIds.w = i;
+                    vertices[id].boneWeights.w = weight;
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+        readSkeleton(skeleton.rootBone, scene->mRootNode, boneInfo);
+    }
+
+    for (const Vertex &vertex : vertices)
+        meshData.bounds.expand(vertex.postition);
+
+    for (unsigned int i = 0; i < mesh->mNumFaces; i++)
+    {
+        const aiFace &face = mesh->mFaces[i];
+        indices.insert(indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
+    }
+
+    if (mesh->mMaterialIndex >= 0)
+    {
+        aiMaterial *material = scene->mMaterials[mesh->mMaterialIndex];
+        std::vector<MaterialTexture> diffuseMaps = loadMaterialTextures(material, aiTextureType_DIFFUSE, "texture_diffuse");
+        meshData.textures.insert(meshData.textures.end(), diffuseMaps.begin(), diffuseMaps.end());
+        std::vector<MaterialTexture> specularMaps = loadMaterialTextures(material, aiTextureType_SPECULAR, "texture_specular");
+        meshData.textures.insert(meshData.textures.end(), specularMaps.begin(), specularMaps.end());
+    }
+
+    // moving the vectors keeps their buffers, so the pointers stay valid
+    data->vertexStorage.push_back(std::move(vertices));
+    data->indexStorage.push_back(std::move(indices));
+
+    meshData.vertices = data->vertexStorage.back().data();
+    meshData.vertexCount = static_cast<uint32_t>(data->vertexStorage.back().size());
+    meshData.indices = data->indexStorage.back().data();
+    meshData.indexCount = static_cast<uint32_t>(data->indexStorage.back().size());
+    data->meshes.push_back(std::move(meshData));
+}
+
+bool ModelImporter::readSkeleton(Bone &boneOutput, aiNode *node, std::unordered_map<std::string, std::pair<int, glm::mat4>> &boneInfoTable)
+{
+    std::string nodeName = node->mName.C_Str();
+
+    if (boneInfoTable.find(nodeName) != boneInfoTable.end())
+    {
+        boneOutput.name = nodeName;
+        boneOutput.id = boneInfoTable[nodeName].first;
+        boneOutput.offset = boneInfoTable[nodeName].second;
+
+        for (unsigned int i = 0; i < node->mNumChildren; i++)
+        {
+            Bone child;
+            readSkeleton(child, node->mChildren[i], boneInfoTable);
+            boneOutput.children.push_back(child);
+        }
+        return true;
+    }
+    else
+    {
+        for (unsigned int i = 0; i < node->mNumChildren; i++)
+        {
+            if (readSkeleton(boneOutput, node->mChildren[i], boneInfoTable))
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void ModelImporter::loadAnimations(const aiScene *scene)
+{
+    if (!scene || scene->mNumAnimations < 1)
+    {
+        return;
+    }
+
+    for (unsigned int i = 0; i < scene->mNumAnimations; ++i)
+    {
+        aiAnimation *aiAnim = scene->mAnimations[i];
+        Animation anim;
+
+        anim.name = aiAnim->mName.C_Str();
+
+        anim.ticksPerSecond = (aiAnim->mTicksPerSecond != 0.0f) ? aiAnim->mTicksPerSecond : 25.0f;
+        anim.duration = aiAnim->mDuration;
+
+        for (unsigned int j = 0; j < aiAnim->mNumChannels; ++j)
+        {
+            aiNodeAnim *channel = aiAnim->mChannels[j];
+            BoneTransformTrack track;
+            for (unsigned int k = 0; k < channel->mNumPositionKeys; ++k)
+            {
+                track.positionTimestamps.push_back(channel->mPositionKeys[k].mTime);
+                track.positions.push_back(assimpToGlmVec3(channel->mPositionKeys[k].mValue));
+            }
+            for (unsigned int k = 0; k < channel->mNumRotationKeys; ++k)
+            {
+                track.rotationTimestamps.push_back(channel->mRotationKeys[k].mTime);
+                track.rotations.push_back(assimpToGlmQuat(channel->mRotationKeys[k].mValue));
+            }
+            for (unsigned int k = 0; k < channel->mNumScalingKeys; ++k)
+            {
+                track.scaleTimestamps.push_back(channel->mScalingKeys[k].mTime);
+                track.scales.push_back(assimpToGlmVec3(channel->mScalingKeys[k].mValue));
+            }
+            anim.boneTransforms[channel->mNodeName.C_Str()] = track;
+        }
+        data->animations.push_back(anim);
+    }
+}
+
+void ModelImporter::inflateSkinnedBounds()
+{
+    const Skeleton &skeleton = data->skeleton;
+    if (skeleton.boneCount == 0 || data->animations.empty())
+        return;
+
+    // sampled poses per clip, the union of the bone boxes keeps the bounds conservative between samples
+    constexpr int SAMPLES_PER_ANIMATION = 32;
+
+    Animator animator;
+    animator.setAnimations(&data->animations);
+    std::vector<glm::mat4> boneMatrices;
+
+    for (MeshData &mesh : data->meshes)
+    {
+        // box of the bind pose vertices each bone influences, a skinned vertex is a
+        // weighted blend of its bones' transforms so it stays inside their union
+        std::vector<AABB> boneBoxes(skeleton.boneCount);
+        bool skinned = false;
+        for (uint32_t v = 0; v < mesh.vertexCount; v++)
+        {
+            const Vertex &vertex = mesh.vertices[v];
+            for (int k = 0; k < 4; k++)
+            {
+                int bone = vertex.boneIds[k];
+                if (vertex.boneWeights[k] > 0.0f && bone >= 0 && bone < (int)boneBoxes.size())
+                {
+                    boneBoxes[bone].expand(vertex.postition);
+                    skinned = true;
+                }
+            }
+        }
+        if (!skinned)
+            continue;
+
+        for (size_t a = 0; a < data->animations.size(); a++)
+        {
+            animator.setAnimation(static_cast<int>(a));
+            float duration = data->animations[a].duration;
+
+            for (int sample = 0; sample <= SAMPLES_PER_ANIMATION; sample++)
+            {
+                animator.seek(duration * sample / SAMPLES_PER_ANIMATION, skeleton, boneMatrices, data->globalInverseTransform);
+                for (size_t bone = 0; bone < boneBoxes.size() && bone < boneMatrices.size(); bone++)
+                    mesh.bounds.expand(boneBoxes[bone].transformed(boneMatrices[bone]));
+            }
+        }
+    }
+}
+
+std::vector<MaterialTexture> ModelImporter::loadMaterialTextures(aiMaterial *mat, aiTextureType type, std::string typeName)
+{
+    std::vector<MaterialTexture> textures;
+    for (unsigned int i = 0; i < mat->GetTextureCount(type); i++)
+    {
+        aiString str;
+        mat->GetTexture(type, i, &str);
+        textures.push_back({std::string(str.C_Str()), typeName, i});
+    }
+    return textures;
+}
@@ -0,0 +1,59 @@
+#include "NodePool.h"
+
+NodePool::NodePool(size_t nodesPerBlock) : nodesPerBlock(nodesPerBlock)
+{
+}
+
+Node *NodePool::create(unsigned int ID, const std::string &name, NodeType type)
+{
+    Node *node;
+    if (!freeList.empty())
+    {
+        node = freeList.back();
+        freeList.pop_back();
+    }
+    else
+    {
+        if (usedBlocks == 0 || blockCursor == nodesPerBlock)
+        {
+            // blocks survive reset(), only grow when a scene is bigger than any before it
+            if (usedBlocks == blocks.size())
+                blocks.push_back(std::make_unique<Node[]>(nodesPerBlock));
+            usedBlocks++;
+            blockCursor = 0;
+        }
+        node = &blocks[usedBlocks - 1][blockCursor++];
+    }
+
+    // assign field by field so a recycled node reuses its name buffer
+    node->ID = ID;
+    node->name = name;
+    node->type = type;
+    node->parent = nullptr;
+    node->firstChild = nullptr;
+    node->lastChild = nullptr;
+    node->prevSibling = nullptr;
+    node->nextSibling = nullptr;
+    node->component = {};
+
+    liveCount++;
+    return node;
+}
+
+void NodePool::destroy(Node *node)
+{
+    if (!node)
+        return;
+
+    node->detach();
+    freeList.push_back(node);
+    liveCount--;
+}
+
+void NodePool::reset()
+{
+    usedBlocks = 0;
+    blockCursor = 0;
+    freeList.clear();
+    liveCount = 0;
+}
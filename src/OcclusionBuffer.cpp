@@ -0,0 +1,240 @@
+#include "OcclusionBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "JobSystem.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define FYNIX_SSE 1
+#include <xmmintrin.h>
+#endif
+
+namespace
+{
+    // triangles or boxes reaching this close to the eye are not clipped, occluders
+    // are dropped and occludees count as visible
+    constexpr float NEAR_W = 1e-3f;
+
+    // edge function e(p) = a * x + b * y + c, positive inside a counter clockwise triangle
+    struct Edge
+    {
+        float a, b, c;
+
+        Edge(const glm::vec3 &from, const glm::vec3 &to)
+        {
+            a = from.y - to.y;
+            b = to.x - from.x;
+            c = -(a * from.x + b * from.y);
+        }
+    };
+}
+
+OcclusionBuffer::OcclusionBuffer()
+{
+    for (int width = WIDTH, height = HEIGHT; width > 0 && height > 0; width /= 2, height /= 2)
+        pyramid.emplace_back(size_t(width) * height, 1.0f);
+}
+
+void OcclusionBuffer::Begin(const glm::mat4 &matrix)
+{
+    viewProjection = matrix;
+    triangles.clear();
+    rasterized = false;
+}
+
+void OcclusionBuffer::AddOccluder(const glm::vec3 *positions, const uint32_t *indices, size_t indexCount, const glm::mat4 &model)
+{
+    // the highest index tells how many vertices to transform
+    uint32_t vertexCount = 0;
+    for (size_t i = 0; i < indexCount; i++)
+        vertexCount = std::max(vertexCount, indices[i] + 1);
+
+    const glm::mat4 matrix = viewProjection * model;
+    clipScratch.resize(vertexCount);
+    for (uint32_t i = 0; i < vertexCount; i++)
+        clipScratch[i] = matrix * glm::vec4(positions[i], 1.0f);
+
+    for (size_t i = 0; i + 2 < indexCount; i += 3)
+    {
+        const glm::vec4 &c0 = clipScratch[indices[i]];
+        const glm::vec4 &c1 = clipScratch[indices[i + 1]];
+        const glm::vec4 &c2 = clipScratch[indices[i + 2]];
+        if (c0.w < NEAR_W || c1.w < NEAR_W || c2.w < NEAR_W)
+            continue;
+
+        ScreenTriangle triangle;
+        const glm::vec4 *clip[3] = {&c0, &c1, &c2};
+        for (int k = 0; k < 3; k++)
+        {
+            glm::vec3 ndc = glm::vec3(*clip[k]) / clip[k]->w;
+            triangle.v[k] = glm::vec3((ndc.x * 0.5f + 0.5f) * WIDTH, (ndc.y * 0.5f + 0.5f) * HEIGHT, ndc.z * 0.5f + 0.5f);
+        }
+
+        float area = (triangle.v[1].x - triangle.v[0].x) * (triangle.v[2].y - triangle.v[0].y) -
+                     (triangle.v[2].x - triangle.v[0].x) * (triangle.v[1].y - triangle.v[0].y);
+        if (std::fabs(area) < 1e-6f)
+            continue;
+        // both windings occlude, the rasterizer wants counter clockwise
+        if (area < 0.0f)
+            std::swap(triangle.v[1], triangle.v[2]);
+
+        float minX = std::min({triangle.v[0].x, triangle.v[1].x, triangle.v[2].x});
+        float maxX = std::max({triangle.v[0].x, triangle.v[1].x, triangle.v[2].x});
+        float minY = std::min({triangle.v[0].y, triangle.v[1].y, triangle.v[2].y});
+        float maxY = std::max({triangle.v[0].y, triangle.v[1].y, triangle.v[2].y});
+        float minZ = std::min({triangle.v[0].z, triangle.v[1].z, triangle.v[2].z});
+        if (maxX < 0.0f || minX >= WIDTH || maxY < 0.0f || minY >= HEIGHT || minZ > 1.0f)
+            continue;
+
+        triangle.minY = std::max(0, static_cast<int>(std::floor(minY)));
+        triangle.maxY = std::min(HEIGHT - 1, static_cast<int>(std::ceil(maxY)));
+        triangles.push_back(triangle);
+    }
+}
+
+void OcclusionBuffer::Rasterize(JobSystem *jobs)
+{
+    constexpr unsigned int bandCount = HEIGHT / BAND_HEIGHT;
+
+    // bands own disjoint rows, so they never write the same pixel
+    auto band = [this](unsigned int index)
+    {
+        rasterizeBand(index * BAND_HEIGHT, (index + 1) * BAND_HEIGHT);
+    };
+
+    if (jobs && !triangles.empty())
+        jobs->parallelFor(bandCount, band);
+    else
+        for (unsigned int i = 0; i < bandCount; i++)
+            band(i);
+
+    buildPyramid();
+    rasterized = true;
+}
+
+void OcclusionBuffer::rasterizeBand(int firstRow, int endRow)
+{
+    float *depth = pyramid[0].data();
+    std::fill(depth + size_t(firstRow) * WIDTH, depth + size_t(endRow) * WIDTH, 1.0f);
+
+    for (const ScreenTriangle &triangle : triangles)
+    {
+        if (triangle.maxY < firstRow || triangle.minY >= endRow)
+            continue;
+
+        const glm::vec3 &v0 = triangle.v[0], &v1 = triangle.v[1], &v2 = triangle.v[2];
+        Edge e0(v1, v2), e1(v2, v0), e2(v0, v1);
+
+        // depth as a plane over the screen, from the barycentric weights
+        float area = e0.a * v0.x + e0.b * v0.y + e0.c;
+        float za = (e0.a * v0.z + e1.a * v1.z + e2.a * v2.z) / area;
+        float zb = (e0.b * v0.z + e1.b * v1.z + e2.b * v2.z) / area;
+        float zc = (e0.c * v0.z + e1.c * v1.z + e2.c * v2.z) / area;
+
+        int minX = std::max(0, static_cast<int>(std::floor(std::min({v0.x, v1.x, v2.x})))) & ~3;
+        int maxX = std::min(WIDTH - 1, static_cast<int>(std::ceil(std::max({v0.x, v1.x, v2.x}))));
+        int minY = std::max(firstRow, triangle.minY);
+        int maxY = std::min(endRow - 1, triangle.maxY);
+
+        for (int y = minY; y <= maxY; y++)
+        {
+            float py = y + 0.5f;
+            float *row = depth + size_t(y) * WIDTH;
+
+#ifdef FYNIX_SSE
+            const __m128 a0 = _mm_set1_ps(e0.a), a1 = _mm_set1_ps(e1.a), a2 = _mm_set1_ps(e2.a), az = _mm_set1_ps(za);
+            const __m128 r0 = _mm_set1_ps(e0.b * py + e0.c), r1 = _mm_set1_ps(e1.b * py + e1.c),
+                         r2 = _mm_set1_ps(e2.b * py + e2.c), rz = _mm_set1_ps(zb * py + zc);
+            const __m128 zero = _mm_setzero_ps();
+
+            for (int x = minX; x <= maxX; x += 4)
+            {
+                __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), _mm_set_ps(3.5f, 2.5f, 1.5f, 0.5f));
+                __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0, px), r0), zero),
+                                                      _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1, px), r1), zero)),
+                                           _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2, px), r2), zero));
+                if (!_mm_movemask_ps(inside))
+                    continue;
+
+                __m128 old = _mm_loadu_ps(row + x);
+                __m128 z = _mm_min_ps(old, _mm_add_ps(_mm_mul_ps(az, px), rz));
+                _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, z), _mm_andnot_ps(inside, old)));
+            }
+#else
+            for (int x = minX; x <= maxX; x++)
+            {
+                float px = x + 0.5f;
+                if (e0.a * px + e0.b * py + e0.c < 0.0f ||
+                    e1.a * px + e1.b * py + e1.c < 0.0f ||
+                    e2.a * px + e2.b * py + e2.c < 0.0f)
+                    continue;
+                row[x] = std::min(row[x], za * px + zb * py + zc);
+            }
+#endif
+        }
+    }
+}
+
+void OcclusionBuffer::buildPyramid()
+{
+    for (size_t level = 1; level < pyramid.size(); level++)
+    {
+        const int width = WIDTH >> level, height = HEIGHT >> level;
+        const float *below = pyramid[level - 1].data();
+        float *out = pyramid[level].data();
+
+        for (int y = 0; y < height; y++)
+        {
+            const float *top = below + size_t(2 * y) * (2 * width);
+            const float *bottom = top + 2 * width;
+            for (int x = 0; x < width; x++)
+                out[y * width + x] = std::max(std::max(top[2 * x], top[2 * x + 1]), std::max(bottom[2 * x], bottom[2 * x + 1]));
+        }
+    }
+}
+
+bool OcclusionBuffer::isVisible(const AABB &worldBox) const
+{
+    if (!rasterized || triangles.empty() || !worldBox.isValid())
+        return true;
+
+    glm::vec2 minScreen(FLT_MAX), maxScreen(-FLT_MAX);
+    float minZ = FLT_MAX;
+    for (int i = 0; i < 8; i++)
+    {
+        glm::vec3 corner((i & 1) ? worldBox.max.x : worldBox.min.x,
+                         (i & 2) ? worldBox.max.y : worldBox.min.y,
+                         (i & 4) ? worldBox.max.z : worldBox.min.z);
+        glm::vec4 clip = viewProjection * glm::vec4(corner, 1.0f);
+        if (clip.w < NEAR_W)
+            return true;
+
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        glm::vec2 screen((ndc.x * 0.5f + 0.5f) * WIDTH, (ndc.y * 0.5f + 0.5f) * HEIGHT);
+        minScreen = glm::min(minScreen, screen);
+        maxScreen = glm::max(maxScreen, screen);
+        minZ = std::min(minZ, ndc.z * 0.5f + 0.5f);
+    }
+
+    if (maxScreen.x < 0.0f || maxScreen.y < 0.0f || minScreen.x >= WIDTH || minScreen.y >= HEIGHT || minZ <= 0.0f)
+        return true;
+
+    int x0 = std::max(0, static_cast<int>(minScreen.x));
+    int y0 = std::max(0, static_cast<int>(minScreen.y));
+    int x1 = std::min(WIDTH - 1, static_cast<int>(maxScreen.x));
+    int y1 = std::min(HEIGHT - 1, static_cast<int>(maxScreen.y));
+
+    // coarsest level where the rectangle still spans a few texels
+    size_t level = 0;
+    while (level + 1 < pyramid.size() && std::max(x1 - x0, y1 - y0) >> level > 3)
+        level++;
+
+    const int width = WIDTH >> level;
+    const float *depth = pyramid[level].data();
+    for (int y = y0 >> level; y <= y1 >> level; y++)
+        for (int x = x0 >> level; x <= x1 >> level; x++)
+            if (depth[y * width + x] > minZ)
+                return true;
+    return false;
+}
@@ -0,0 +1,93 @@
+#include "OffscreenTarget.h"
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+
+OffscreenTarget::~OffscreenTarget()
+{
+    destroy();
+}
+
+bool OffscreenTarget::Create(int newWidth, int newHeight)
+{
+    destroy();
+    width = newWidth;
+    height = newHeight;
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+    glGenRenderbuffers(2, renderbuffers);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cerr << "[OffscreenTarget - ERROR] Framebuffer incomplete (0x" << std::hex << status << std::dec << ")" << std::endl;
+        destroy();
+        return false;
+    }
+
+    std::cout << "[OffscreenTarget] Created " << width << "x" << height << " target." << std::endl;
+    return true;
+}
+
+void OffscreenTarget::destroy()
+{
+    if (framebuffer)
+        glDeleteFramebuffers(1, &framebuffer);
+    if (renderbuffers[0])
+        glDeleteRenderbuffers(2, renderbuffers);
+    framebuffer = 0;
+    renderbuffers[0] = renderbuffers[1] = 0;
+    width = height = 0;
+}
+
+void OffscreenTarget::Bind()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, width, height);
+}
+
+void OffscreenTarget::ReadPixels(std::vector<unsigned char> &rgb)
+{
+    const size_t rowSize = size_t(width) * 3;
+    rgb.resize(rowSize * height);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    // rows of 3 bytes are not 4 byte aligned for every width
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, rgb.data());
+
+    // GL reads bottom up, images are stored top down
+    std::vector<unsigned char> row(rowSize);
+    for (int y = 0; y < height / 2; y++)
+    {
+        unsigned char *top = rgb.data() + y * rowSize;
+        unsigned char *bottom = rgb.data() + (height - 1 - y) * rowSize;
+        std::memcpy(row.data(), top, rowSize);
+        std::memcpy(top, bottom, rowSize);
+        std::memcpy(bottom, row.data(), rowSize);
+    }
+}
+
+bool OffscreenTarget::WritePPM(const std::string &path, int width, int height, const std::vector<unsigned char> &rgb)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << "P6\n"
+        << width << " " << height << "\n255\n";
+    if (!out.write(reinterpret_cast<const char *>(rgb.data()), rgb.size()))
+    {
+        std::cerr << "[OffscreenTarget] Could not write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -3,14 +3,15 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <vector>
+#include <cstring>
+
+#include "GLState.h"
 
 ParticleEmitter::ParticleEmitter(Shader shader, unsigned int maxParticles)
     : shader(shader), maxParticles(maxParticles), lastUsedParticle(0)
 {
     this->particles.resize(maxParticles);
 
-    this->particleData.resize(maxParticles * 8);
-
     init();
 }
 
@@ -19,8 +20,6 @@ ParticleEmitter::ParticleEmitter(Shader shader, unsigned int maxParticles, unsig
 {
     this->particles.resize(maxParticles);
 
-    this->particleData.resize(maxParticles * 8);
-
     init();
 
     std::cout << "[ParticleSystem] Created a new Particle emitter with shader: " << shader.Name << std::endl;
@@ -37,32 +36,24 @@ void ParticleEmitter::init()
     };
 
     glGenVertexArrays(1, &this->VAO);
-    glBindVertexArray(this->VAO);
+    GLState::BindVertexArray(this->VAO);
 
     unsigned int VBO;
     glGenBuffers(1, &VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(particle_quad), particle_quad, GL_STATIC_DRAW);
 
     glEnableVertexAttribArray(0);
     glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void *)0);
 
-    glGenBuffers(1, &this->instanceVBO);
-    glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
-
-    // GPT SUCCKS, GEMINI >>>>>
-    glBufferData(GL_ARRAY_BUFFER, maxParticles * 8 * sizeof(float), NULL, GL_DYNAMIC_DRAW);
-
+    // per-particle data comes from the frame's stream allocation, pointed at in Draw()
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *)0);
-
     glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *)(4 * sizeof(float)));
 
     glVertexAttribDivisor(1, 1);
     glVertexAttribDivisor(2, 1);
 
-    glBindVertexArray(0);
+    GLState::BindVertexArray(0);
 }
 
 void ParticleEmitter::SpawnParticle(Particle particle)
@@ -91,50 +82,43 @@ void ParticleEmitter::Update(float deltaTime)
     }
 }
 
-void ParticleEmitter::Draw()
+size_t ParticleEmitter::CopyInstances(std::vector<ParticleInstance> &out) const
 {
-    int dataIndex = 0;
-    int activeParticles = 0;
-
+    size_t first = out.size();
     for (const Particle &p : this->particles)
     {
-        if (p.Life > 0.0f)
-        {
-            // Copy position and size (as w-component)
-            this->particleData[dataIndex++] = p.Position.x;
-            this->particleData[dataIndex++] = p.Position.y;
-            this->particleData[dataIndex++] = p.Position.z;
-            this->particleData[dataIndex++] = p.Size; // Use the particle's size
-
-            // Copy color data
-            this->particleData[dataIndex++] = p.Color.r;
-            this->particleData[dataIndex++] = p.Color.g;
-            this->particleData[dataIndex++] = p.Color.b;
-            this->particleData[dataIndex++] = p.Color.a;
-
-            activeParticles++;
-        }
+        if (p.Life <= 0.0f)
+            continue;
+        out.push_back({glm::vec4(p.Position, p.Size), p.Color});
     }
+    return out.size() - first;
+}
 
-    if (activeParticles > 0)
-    {
-        // Bind the instance VBO to update its data
-        glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, activeParticles * 8 * sizeof(float), &this->particleData[0]);
+void ParticleEmitter::Draw(StreamBuffer &stream, const ParticleInstance *instances, size_t count)
+{
+    if (count == 0)
+        return;
 
-        // Use the particle shader and bind the VAO
-        this->shader.use();
-        glBindVertexArray(this->VAO);
+    StreamAllocation allocation = stream.Allocate(count * sizeof(ParticleInstance));
+    if (!allocation)
+        return;
+    std::memcpy(allocation.data, instances, count * sizeof(ParticleInstance));
+    stream.Commit(allocation);
 
-        // Enable blending for transparent particles
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE); // Additive blending for fire/smoke
+    // Use the particle shader and bind the VAO
+    this->shader.use();
+    GLState::BindVertexArray(this->VAO);
 
-        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, activeParticles);
+    const char *base = reinterpret_cast<const char *>(allocation.offset);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, allocation.buffer);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), base);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), base + sizeof(glm::vec4));
 
-        glBindVertexArray(0);
-        glDisable(GL_BLEND);
-    }
+    // Enable blending for transparent particles, SceneManager turns it off after the last emitter
+    GLState::SetBlend(true);
+    GLState::BlendFunc(GL_SRC_ALPHA, GL_ONE); // Additive blending for fire/smoke
+
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(count));
 }
 
 unsigned int ParticleEmitter::firstUnusedParticle()
@@ -62,43 +62,46 @@ void PhysicsEngine::update(float deltaTime)
     m_dynamicsWorld->stepSimulation(deltaTime, 10);
 }
 
-void PhysicsEngine::Draw(Shader &shader)
+glm::mat4 PhysicsEngine::getDebugMatrix(btRigidBody *body, const glm::mat4 &worldMatrix)
 {
-    shader.use();
-
-    btCollisionObjectArray &objects = m_dynamicsWorld->getCollisionObjectArray();
+    glm::vec3 scale(1.0f, 1.0f, 1.0f);
+    btCollisionShape *shape = body->getCollisionShape();
 
-    for (int i = 0; i < m_dynamicsWorld->getNumCollisionObjects(); i++)
+    if (shape->getShapeType() == BOX_SHAPE_PROXYTYPE)
     {
-        btCollisionObject *obj = objects[i];
-        btRigidBody *body = btRigidBody::upcast(obj);
-
-        if (body && body->getMotionState())
-        {
-            btTransform trans;
-            body->getMotionState()->getWorldTransform(trans);
-
-            glm::vec3 scale(1.0f, 1.0f, 1.0f);
-            btCollisionShape *shape = body->getCollisionShape();
-
-            if (shape->getShapeType() == BOX_SHAPE_PROXYTYPE)
-            {
-                btBoxShape *boxShape = static_cast<btBoxShape *>(shape);
-                btVector3 halfExtents = boxShape->getHalfExtentsWithMargin();
-                scale = glm::vec3(halfExtents.x() * 2.0f, halfExtents.y() * 2.0f, halfExtents.z() * 2.0f);
-            }
+        btBoxShape *boxShape = static_cast<btBoxShape *>(shape);
+        btVector3 halfExtents = boxShape->getHalfExtentsWithMargin();
+        scale = glm::vec3(halfExtents.x() * 2.0f, halfExtents.y() * 2.0f, halfExtents.z() * 2.0f);
+    }
 
-            glm::mat4 modelMatrix;
-            trans.getOpenGLMatrix(glm::value_ptr(modelMatrix));
+    return glm::scale(worldMatrix, scale);
+}
 
-            modelMatrix = glm::scale(modelMatrix, scale);
+glm::mat4 PhysicsEngine::getBodyTransform(btRigidBody *body)
+{
+    btTransform trans;
+    if (body->getMotionState())
+        body->getMotionState()->getWorldTransform(trans);
+    else
+        trans = body->getWorldTransform();
 
-            shader.setUniforms("uLightColor", static_cast<unsigned int>(UniformType::Vec3f), (void *)(glm::value_ptr(glm::vec3(1.f))));
-            shader.setUniforms("model", static_cast<unsigned int>(UniformType::Mat4f), (void *)(glm::value_ptr(modelMatrix)));
+    glm::mat4 worldMatrix;
+    trans.getOpenGLMatrix(glm::value_ptr(worldMatrix));
+    return worldMatrix;
+}
 
-            debugMesh.Draw(shader);
-        }
-    }
+void PhysicsEngine::setBodyTransform(btRigidBody *body, const glm::mat4 &worldMatrix)
+{
+    glm::mat4 rigid = worldMatrix;
+    rigid[0] = glm::vec4(glm::normalize(glm::vec3(rigid[0])), 0.f);
+    rigid[1] = glm::vec4(glm::normalize(glm::vec3(rigid[1])), 0.f);
+    rigid[2] = glm::vec4(glm::normalize(glm::vec3(rigid[2])), 0.f);
+
+    btTransform trans;
+    trans.setFromOpenGLMatrix(glm::value_ptr(rigid));
+    body->setWorldTransform(trans);
+    if (body->getMotionState())
+        body->getMotionState()->setWorldTransform(trans);
 }
 
 btDiscreteDynamicsWorld *PhysicsEngine::getDynamicsWorld()
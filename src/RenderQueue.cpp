@@ -0,0 +1,343 @@
+#include "RenderQueue.h"
+#include "GLState.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace
+{
+    // texture units a material may use, the rest is left to other systems
+    constexpr unsigned int MAX_MATERIAL_TEXTURES = 8;
+
+    void addStats(RenderStats &total, const RenderStats &flush)
+    {
+        total.drawCalls += flush.drawCalls;
+        total.instances += flush.instances;
+        total.programSwitches += flush.programSwitches;
+        total.textureBinds += flush.textureBinds;
+        total.vertexArrayBinds += flush.vertexArrayBinds;
+    }
+}
+
+void DrawPacket::setTransform(const glm::mat4 &model, const glm::mat3 &normalMatrix)
+{
+    instance.model = model;
+    for (int i = 0; i < 3; i++)
+        instance.normalMatrix[i] = glm::vec4(normalMatrix[i], 0.0f);
+}
+
+void RenderQueue::Begin(const glm::vec3 &camPos)
+{
+    this->camPos = camPos;
+    packets.clear();
+    entries.clear();
+}
+
+uint64_t RenderQueue::MakeKey(RenderPass pass, unsigned int program, uint32_t material, unsigned int mesh, float depth)
+{
+    float normalized = std::min(std::max(depth / MAX_SORT_DEPTH, 0.0f), 1.0f);
+    if (pass == RenderPass::Transparent)
+        normalized = 1.0f - normalized;
+    uint64_t depthBits = static_cast<uint64_t>(normalized * 0xFFFF);
+
+    return (static_cast<uint64_t>(pass) & 0xF) << 60 |
+           (static_cast<uint64_t>(program) & 0x3FF) << 50 |
+           (static_cast<uint64_t>(material) & 0x3FFFF) << 32 |
+           (static_cast<uint64_t>(mesh) & 0xFFFF) << 16 |
+           depthBits;
+}
+
+uint32_t RenderQueue::MaterialKey(const Mesh &mesh)
+{
+    // FNV-1a over the texture names, a collision only costs a few extra binds
+    uint32_t hash = 2166136261u;
+    for (const Texture &texture : mesh.textures)
+    {
+        hash ^= texture.ID;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void RenderQueue::Submit(const DrawPacket &packet, RenderPass pass)
+{
+    float depth = glm::length(glm::vec3(packet.instance.model[3]) - camPos);
+    // arena meshes share a VAO, so the mesh bits come from its address instead
+    unsigned int meshBits = static_cast<unsigned int>(reinterpret_cast<uintptr_t>(packet.mesh) >> 4);
+    uint64_t key = MakeKey(pass, packet.shader->ID, MaterialKey(*packet.mesh), meshBits, depth);
+
+    entries.push_back({key, static_cast<uint32_t>(packets.size())});
+    packets.push_back(packet);
+}
+
+void RenderQueue::RadixSort()
+{
+    const size_t count = entries.size();
+    scratch.resize(count);
+
+    // LSD radix sort, 8 bits per pass, stable so equal keys keep submission order
+    for (unsigned int shift = 0; shift < 64; shift += 8)
+    {
+        size_t histogram[256] = {};
+        for (const SortEntry &entry : entries)
+            histogram[(entry.key >> shift) & 0xFF]++;
+
+        // every key shares this byte, nothing to reorder
+        if (histogram[(entries[0].key >> shift) & 0xFF] == count)
+            continue;
+
+        size_t offset = 0;
+        for (size_t &bucket : histogram)
+        {
+            size_t n = bucket;
+            bucket = offset;
+            offset += n;
+        }
+
+        for (const SortEntry &entry : entries)
+            scratch[histogram[(entry.key >> shift) & 0xFF]++] = entry;
+
+        entries.swap(scratch);
+    }
+}
+
+void RenderQueue::Flush(StreamBuffer &stream)
+{
+    if (entries.empty())
+        return;
+
+    RenderStats unsorted, sorted;
+    multiDrawReady = GLExtensions::multiDrawIndirect;
+    BuildBatches();
+    Replay(false, unsorted);
+
+    RadixSort();
+    BuildBatches();
+    if (!WriteInstances(stream))
+        return;
+    WriteCommands(stream);
+    // without commands the arena batches take the per-mesh path
+    multiDrawReady = static_cast<bool>(commandData);
+    Replay(true, sorted);
+
+    addStats(frameUnsorted, unsorted);
+    addStats(frameSorted, sorted);
+}
+
+void RenderQueue::EndFrame()
+{
+    sortedStats = frameSorted;
+    unsortedStats = frameUnsorted;
+    frameSorted = frameUnsorted = RenderStats();
+}
+
+bool RenderQueue::WriteInstances(StreamBuffer &stream)
+{
+    instanceData = stream.Allocate(entries.size() * sizeof(InstanceData), 16);
+    if (!instanceData)
+        return false;
+
+    // sorted order, so every batch is a contiguous range
+    InstanceData *out = static_cast<InstanceData *>(instanceData.data);
+    for (size_t i = 0; i < entries.size(); i++)
+        out[i] = packets[entries[i].index].instance;
+
+    stream.Commit(instanceData);
+    return true;
+}
+
+void RenderQueue::BuildBatches()
+{
+    batches.clear();
+    for (uint32_t first = 0; first < entries.size();)
+    {
+        const DrawPacket &packet = packets[entries[first].index];
+
+        uint32_t last = first + 1;
+        while (last < entries.size())
+        {
+            const DrawPacket &next = packets[entries[last].index];
+            if (next.mesh != packet.mesh || next.shader->ID != packet.shader->ID)
+                break;
+            last++;
+        }
+
+        batches.push_back({first, last - first, packet.mesh, packet.shader, 0});
+        first = last;
+    }
+}
+
+void RenderQueue::WriteCommands(StreamBuffer &stream)
+{
+    commandData = StreamAllocation();
+    if (!GLExtensions::multiDrawIndirect)
+        return;
+
+    size_t commandCount = 0;
+    for (const Batch &batch : batches)
+        if (batch.mesh->arena)
+            commandCount++;
+    if (commandCount == 0)
+        return;
+
+    commandData = stream.Allocate(commandCount * sizeof(DrawElementsIndirectCommand), 16);
+    if (!commandData)
+        return;
+
+    DrawElementsIndirectCommand *out = static_cast<DrawElementsIndirectCommand *>(commandData.data);
+    uint32_t next = 0;
+    for (Batch &batch : batches)
+    {
+        if (!batch.mesh->arena)
+            continue;
+        batch.command = next;
+
+        const GeometryRange &range = batch.mesh->range;
+        out[next++] = {range.indexCount, batch.count, range.firstIndex, static_cast<GLint>(range.baseVertex), batch.first};
+    }
+
+    stream.Commit(commandData);
+}
+
+bool RenderQueue::CanMultiDraw(const Batch &batch) const
+{
+    return multiDrawReady && batch.mesh->arena;
+}
+
+bool RenderQueue::SameTextures(const Mesh &a, const Mesh &b)
+{
+    if (a.textures.size() != b.textures.size())
+        return false;
+    for (size_t i = 0; i < a.textures.size(); i++)
+        if (a.textures[i].ID != b.textures[i].ID)
+            return false;
+    return true;
+}
+
+void RenderQueue::PointInstanceAttribs(size_t firstInstance)
+{
+    // no base instance in GL 3.3, so each batch re-points the bound VAO at its range
+    const GLsizei stride = sizeof(InstanceData);
+    const char *base = reinterpret_cast<const char *>(instanceData.offset + firstInstance * sizeof(InstanceData));
+
+    GLState::BindBuffer(GL_ARRAY_BUFFER, instanceData.buffer);
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        unsigned int location = INSTANCE_ATTRIB_FIRST + i;
+        glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, stride, base + offsetof(InstanceData, model) + i * sizeof(glm::vec4));
+    }
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        unsigned int location = INSTANCE_ATTRIB_FIRST + 4 + i;
+        glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, stride, base + offsetof(InstanceData, normalMatrix) + i * sizeof(glm::vec4));
+    }
+    glVertexAttribPointer(INSTANCE_ATTRIB_FIRST + 7, 4, GL_FLOAT, GL_FALSE, stride, base + offsetof(InstanceData, color));
+    glVertexAttribIPointer(INSTANCE_ATTRIB_FIRST + 8, 1, GL_INT, stride, base + offsetof(InstanceData, boneOffset));
+
+    for (unsigned int location = INSTANCE_ATTRIB_FIRST; location <= INSTANCE_ATTRIB_FIRST + 8; location++)
+    {
+        glEnableVertexAttribArray(location);
+        glVertexAttribDivisor(location, 1);
+    }
+}
+
+void RenderQueue::Replay(bool issue, RenderStats &stats)
+{
+    unsigned int currentProgram = 0, currentVAO = 0;
+    unsigned int boundTextures[MAX_MATERIAL_TEXTURES] = {};
+    const Mesh *lastSamplerMesh = nullptr;
+    // the arena VAO reads instances from offset 0 when baseInstance does the indexing
+    bool arenaAttribsPointed = false;
+
+    for (size_t b = 0; b < batches.size();)
+    {
+        const Batch &batch = batches[b];
+        Mesh &mesh = *batch.mesh;
+        Shader &shader = *batch.shader;
+
+        // following batches that can ride along in the same multi-draw
+        size_t end = b + 1;
+        const bool multiDraw = CanMultiDraw(batch);
+        if (multiDraw)
+        {
+            while (end < batches.size())
+            {
+                const Batch &next = batches[end];
+                if (!CanMultiDraw(next) || next.mesh->arena != mesh.arena ||
+                    next.shader->ID != shader.ID || !SameTextures(*next.mesh, mesh))
+                    break;
+                end++;
+            }
+        }
+
+        if (shader.ID != currentProgram)
+        {
+            currentProgram = shader.ID;
+            stats.programSwitches++;
+            lastSamplerMesh = nullptr;
+            if (issue)
+                shader.use();
+        }
+
+        const unsigned int textureCount = std::min<unsigned int>(static_cast<unsigned int>(mesh.textures.size()), MAX_MATERIAL_TEXTURES);
+        for (unsigned int i = 0; i < textureCount; i++)
+        {
+            if (boundTextures[i] == mesh.textures[i].ID)
+                continue;
+            boundTextures[i] = mesh.textures[i].ID;
+            stats.textureBinds++;
+            if (issue)
+                mesh.textures[i].Bind(i);
+        }
+
+        // sampler uniforms are program state, only needed when the texture layout may differ
+        if (issue && lastSamplerMesh != &mesh &&
+            (!lastSamplerMesh || lastSamplerMesh->samplerNames != mesh.samplerNames))
+        {
+            for (unsigned int i = 0; i < textureCount; i++)
+                shader.setInt(shader.getUniformLocation(mesh.samplerNames[i]), i);
+        }
+        lastSamplerMesh = &mesh;
+
+        if (mesh.VAO.ID != currentVAO)
+        {
+            currentVAO = mesh.VAO.ID;
+            stats.vertexArrayBinds++;
+        }
+
+        stats.drawCalls++;
+        for (size_t i = b; i < end; i++)
+            stats.instances += batches[i].count;
+
+        if (issue)
+        {
+            mesh.VAO.Bind();
+            if (multiDraw)
+            {
+                if (!arenaAttribsPointed)
+                {
+                    PointInstanceAttribs(0);
+                    arenaAttribsPointed = true;
+                }
+                GLState::BindBuffer(GL_DRAW_INDIRECT_BUFFER, commandData.buffer);
+                GLExtensions::MultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+                                                        (void *)(commandData.offset + batch.command * sizeof(DrawElementsIndirectCommand)),
+                                                        static_cast<GLsizei>(end - b), 0);
+            }
+            else
+            {
+                PointInstanceAttribs(batch.first);
+                if (mesh.arena)
+                    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT,
+                                                      (void *)(mesh.range.firstIndex * sizeof(unsigned int)),
+                                                      batch.count, mesh.range.baseVertex);
+                else if (mesh.indexCount > 0)
+                    glDrawElementsInstanced(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, 0, batch.count);
+                else
+                    glDrawArraysInstanced(GL_TRIANGLES, 0, 36, batch.count);
+            }
+        }
+
+        b = end;
+    }
+}
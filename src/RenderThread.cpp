@@ -0,0 +1,130 @@
+#include "RenderThread.h"
+
+#include <iostream>
+#include <chrono>
+
+RenderThread::~RenderThread()
+{
+    Stop();
+}
+
+void RenderThread::SetDrawFunction(DrawFunction function)
+{
+    draw = std::move(function);
+}
+
+void RenderThread::Start(GLFWwindow *renderWindow)
+{
+    if (isRunning())
+        return;
+
+    window = renderWindow;
+    stopping = false;
+    // a context is current on one thread at a time
+    glfwMakeContextCurrent(nullptr);
+    thread = std::thread(&RenderThread::threadLoop, this);
+
+    std::cout << "[RenderThread] Drawing on a dedicated thread." << std::endl;
+}
+
+void RenderThread::Stop()
+{
+    if (!isRunning())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    thread.join();
+
+    glfwMakeContextCurrent(window);
+}
+
+FramePacket &RenderThread::BeginPacket()
+{
+    FramePacket &packet = packets[filling];
+    if (isRunning())
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&]
+                      { return !submitted[filling]; });
+        waitMs = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+    }
+
+    packet.clear();
+    packet.frameNumber = frameNumber++;
+    return packet;
+}
+
+void RenderThread::SubmitPacket()
+{
+    FramePacket &packet = packets[filling];
+    filling ^= 1;
+
+    if (!isRunning())
+    {
+        draw(packet);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        submitted[filling ^ 1] = true;
+    }
+    wake.notify_one();
+}
+
+void RenderThread::Run(const std::function<void()> &fn)
+{
+    if (!isRunning() || std::this_thread::get_id() == thread.get_id())
+    {
+        fn();
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    task = &fn;
+    wake.notify_one();
+    finished.wait(lock, [this]
+                  { return task == nullptr; });
+}
+
+void RenderThread::threadLoop()
+{
+    glfwMakeContextCurrent(window);
+
+    unsigned int drawing = 0;
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true)
+    {
+        wake.wait(lock, [&]
+                  { return submitted[drawing] || task || stopping; });
+
+        // packets before tasks, a task may free what an already submitted packet still draws
+        if (submitted[drawing])
+        {
+            lock.unlock();
+            draw(packets[drawing]);
+            lock.lock();
+            submitted[drawing] = false;
+            drawing ^= 1;
+            finished.notify_all();
+        }
+        else if (task)
+        {
+            lock.unlock();
+            (*task)();
+            lock.lock();
+            task = nullptr;
+            finished.notify_all();
+        }
+        else
+            break;
+    }
+    lock.unlock();
+
+    glfwMakeContextCurrent(nullptr);
+}
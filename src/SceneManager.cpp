@@ -1,7 +1,20 @@
 #include "SceneManager.h"
 
+#include <cstring>
+
+#include "GLState.h"
+#include "GBuffer.h"
+#include "RenderThread.h"
+
 using json = nlohmann::json;
 
+namespace
+{
+    // particles spread up to 5 units/s sideways and rise 5 units/s for 1.5s, see updateParticles()
+    const AABB EMITTER_BOUNDS = {glm::vec3(-7.5f, 0.0f, -7.5f), glm::vec3(7.5f, 7.5f, 7.5f)};
+    const AABB GIZMO_BOUNDS = {glm::vec3(-0.5f), glm::vec3(0.5f)};
+}
+
 std::string SceneManager::nodeTypeToString(NodeType type)
 {
     switch (type)
@@ -42,7 +55,8 @@ NodeType SceneManager::stringToNodeType(const std::string &str)
 
 SceneManager::SceneManager(const std::string &projectPath) : projectPath(projectPath)
 {
-    nodes.push_back(root);
+    root = nodePool.create(0, "Root", NodeType::Root);
+    registerNode(root);
     nextID = 1;
 
     std::cout << "[SceneManager] Initializing SceneManager with project path: " << projectPath << std::endl;
@@ -61,14 +75,13 @@ void SceneManager::addToParent(std::string &name, NodeType type, unsigned int pa
     }
 
     nextID = assignedID + 1;
-    Node *newNode = new Node({assignedID, name, type, parentNode, {}});
-    nodes.push_back(newNode);
-    parentNode->children.push_back(newNode);
+    Node *newNode = nodePool.create(assignedID, name, type);
+    parentNode->appendChild(newNode);
+    registerNode(newNode);
 
     if (type == NodeType::Light)
     {
-        Light light(newNode->ID, lightType);
-        lights.push_back(light);
+        newNode->component = lights.insert(Light(newNode->ID, lightType));
     }
     std::cout << "[SceneManager] Added new node with ID: " << newNode->ID << " and name: " << newNode->name << std::endl;
 }
@@ -84,14 +97,13 @@ void SceneManager::addToParent(std::string &name, std::string &filepath, NodeTyp
         return;
     }
     nextID = assignedID + 1;
-    Node *newNode = new Node({assignedID, name, type, parentNode, {}});
-    nodes.push_back(newNode);
-    parentNode->children.push_back(newNode);
+    Node *newNode = nodePool.create(assignedID, name, type);
+    parentNode->appendChild(newNode);
+    registerNode(newNode);
 
     if (type == NodeType::Model)
     {
-        Model model(filepath, newNode->ID);
-        models.push_back(model);
+        newNode->component = models.insert(Model(assets.loadModel(filepath), newNode->ID));
         std::cout << "[SceneManager] Model loaded and added to node with ID: " << newNode->ID << std::endl;
     }
 
@@ -109,14 +121,13 @@ void SceneManager::addToParent(std::string &name, NodeType type, unsigned int pa
     }
 
     nextID = assignedID + 1;
-    Node *newNode = new Node({assignedID, name, type, parentNode, {}});
-    nodes.push_back(newNode);
-    parentNode->children.push_back(newNode);
+    Node *newNode = nodePool.create(assignedID, name, type);
+    parentNode->appendChild(newNode);
+    registerNode(newNode);
 
     if (type == NodeType::Particles)
     {
-        ParticleEmitter particleEmitter(sm->findShader("particle"), maxParticles, assignedID);
-        particleEmitters.push_back(particleEmitter);
+        newNode->component = particleEmitters.insert(ParticleEmitter(sm->findShader("particle"), maxParticles, assignedID));
 
         addToParent(name, NodeType::Light, assignedID, LightType::POINTLIGHT);
     }
@@ -145,9 +156,9 @@ void SceneManager::addToParent(std::string &name, NodeType type, unsigned int pa
     }
 
     nextID = assignedID + 1;
-    Node *newNode = new Node({assignedID, name, type, parentNode, {}});
-    nodes.push_back(newNode);
-    parentNode->children.push_back(newNode);
+    Node *newNode = nodePool.create(assignedID, name, type);
+    parentNode->appendChild(newNode);
+    registerNode(newNode);
 
     btRigidBody *body = nullptr;
 
@@ -155,6 +166,7 @@ void SceneManager::addToParent(std::string &name, NodeType type, unsigned int pa
     {
         body = physics->createBoxRigidBody(glm::vec3(1.f), glm::vec3(1.f), mass);
         rigidBodies[newNode->ID] = body;
+        transforms.setPosition(newNode->ID, glm::vec3(1.f));
     }
 
     std::cout << "[SceneManager] Added new node with ID: " << newNode->ID << " and name: " << newNode->name << std::endl;
@@ -171,49 +183,60 @@ void SceneManager::addToParent(std::string &name, NodeType type, unsigned int pa
     }
 
     nextID = assignedID + 1;
-    Node *newNode = new Node({assignedID, name, type, parentNode, {}});
-    nodes.push_back(newNode);
-    parentNode->children.push_back(newNode);
+    Node *newNode = nodePool.create(assignedID, name, type);
+    parentNode->appendChild(newNode);
+    registerNode(newNode);
 
     std::cout << "[SceneManager] Added new node with ID: " << newNode->ID << " and name: " << newNode->name << std::endl;
 }
 
-void SceneManager::RenderModels(Shader &shader, float deltaTime)
+void SceneManager::withContext(const std::function<void()> &fn)
 {
-    int lightCount = lights.size();
-    shader.setUniforms("numLights", (unsigned int)UniformType::Int, &lightCount);
+    if (renderThread)
+        renderThread->Run(fn);
+    else
+        fn();
+}
+
+void SceneManager::Update(float deltaTime)
+{
+    // finished background imports become GL objects here, within the upload budget.
+    // that waits for the render thread to finish its frame, so only when there is something
+    if (assets.hasPendingUploads())
+        withContext([this]
+                    { assets.processUploads(); });
 
-    for (int i = 0; i < lightCount; ++i)
+    // while simulating bullet owns rigid body transforms, otherwise the editor does
+    if (physics && simulate)
     {
-        std::string posName = "lightPositions[" + std::to_string(i) + "]";
-        std::string colName = "lightColors[" + std::to_string(i) + "]";
+        physics->update(deltaTime);
+        for (auto &[id, body] : rigidBodies)
+            if (body->isActive())
+                transforms.setWorldMatrix(id, physics->getBodyTransform(body));
+    }
+
+    transforms.update();
 
-        shader.setUniforms(posName.c_str(), (unsigned int)UniformType::Vec3f, (void *)(glm::value_ptr(lights[i].position)));
-        shader.setUniforms(colName.c_str(), (unsigned int)UniformType::Vec3f, (void *)(glm::value_ptr(lights[i].color)));
+    if (physics && !simulate)
+    {
+        for (auto &[id, body] : rigidBodies)
+            if (transforms.wasUpdated(id))
+                physics->setBodyTransform(body, transforms.getWorldMatrix(id));
     }
 
+    for (ParticleEmitter &emitter : particleEmitters)
+        if (transforms.wasUpdated(emitter.ID))
+            emitter.Position = transforms.getWorldPosition(emitter.ID);
+
+    updateSpatial();
+
     for (Model &model : models)
-    {
         if (model.hasAnimation)
             model.UpdateAnimation(deltaTime);
-
-        glm::mat4 modelMat = model.getModelMatrix();
-        shader.setUniforms("model", (unsigned int)UniformType::Mat4f, glm::value_ptr(modelMat));
-        model.Draw(shader);
-    }
-}
-
-void SceneManager::RenderLights(Shader &shader)
-{
-    if (drawLights)
-        for (auto &light : lights)
-        {
-            shader.use();
-            light.Draw(shader);
-        }
+    updateParticles(deltaTime);
 }
 
-void SceneManager::RenderParticles(float dt)
+void SceneManager::updateParticles(float deltaTime)
 {
     for (auto &emitter : particleEmitters)
     {
@@ -229,22 +252,347 @@ void SceneManager::RenderParticles(float dt)
             emitter.SpawnParticle(newParticle);
         }
 
-        emitter.Update(dt);
-        emitter.Draw();
+        emitter.Update(deltaTime);
+    }
+}
+
+void SceneManager::updateSpatial()
+{
+    auto needsUpdate = [&](unsigned int nodeID)
+    {
+        return nodeID >= spatialProxies.size() || !spatialProxies[nodeID].settled || transforms.wasUpdated(nodeID);
+    };
+
+    for (Model &model : models)
+    {
+        if (!needsUpdate(model.ID))
+            continue;
+
+        // the placeholder's bounds while loading, the asset's afterwards
+        drawMeshes.clear();
+        model.collectMeshes(drawMeshes);
+        AABB local;
+        for (Mesh *mesh : drawMeshes)
+            local.expand(mesh->bounds);
+        if (!local.isValid())
+            local = GIZMO_BOUNDS;
+
+        placeProxy(model.ID, local.transformed(transforms.getWorldMatrix(model.ID)), model.getAsset()->state != AssetState::Loading);
     }
+
+    for (Light &light : lights)
+        if (needsUpdate(light.ID))
+            placeProxy(light.ID, GIZMO_BOUNDS.transformed(light.getGizmoMatrix(transforms.getWorldPosition(light.ID))), true);
+
+    for (ParticleEmitter &emitter : particleEmitters)
+        if (needsUpdate(emitter.ID))
+            placeProxy(emitter.ID, EMITTER_BOUNDS.transformed(transforms.getWorldMatrix(emitter.ID)), true);
 }
 
-void SceneManager::RenderPhysics(float dt, Shader &shader)
+void SceneManager::placeProxy(unsigned int nodeID, const AABB &worldBox, bool settled)
 {
-    if (simulate)
-        physics->update(dt);
+    if (nodeID >= spatialProxies.size())
+        spatialProxies.resize(nodeID + 1);
+
+    SpatialProxy &entry = spatialProxies[nodeID];
+    if (entry.proxy == AABBTree::NONE)
+        entry.proxy = spatial.insert(worldBox, nodeID);
+    else
+        spatial.move(entry.proxy, worldBox);
+    entry.settled = settled;
+}
+
+void SceneManager::removeProxy(unsigned int nodeID)
+{
+    if (nodeID >= spatialProxies.size() || spatialProxies[nodeID].proxy == AABBTree::NONE)
+        return;
+
+    spatial.remove(spatialProxies[nodeID].proxy);
+    spatialProxies[nodeID] = {};
+}
+
+void SceneManager::BuildFramePacket(FramePacket &packet, const glm::mat4 &view, const glm::mat4 &projection, const glm::vec3 &camPos)
+{
+    packet.frame.view = view;
+    packet.frame.projection = projection;
+    packet.frame.camPos = glm::vec4(camPos, 1.0f);
+    frustum = Frustum(projection * view);
+
+    clusterLights.clear();
+    for (Light &light : lights)
+        clusterLights.push_back({transforms.getWorldPosition(light.ID), light.radius, light.color, light.type == LightType::DIRECTIONAL});
+    packet.lightClusters.Build(clusterLights, view, projection, jobs);
+    lightClusters = &packet.lightClusters;
+
+    collectModels(packet);
+
+    if (drawLights)
+        for (Light &light : lights)
+        {
+            InstanceData &gizmo = packet.lightGizmos.emplace_back();
+            gizmo.model = light.getGizmoMatrix(transforms.getWorldPosition(light.ID));
+            gizmo.color = glm::vec4(light.color, 1.0f);
+        }
+
+    for (ParticleEmitter &emitter : particleEmitters)
+    {
+        size_t first = packet.particles.size();
+        size_t count = emitter.CopyInstances(packet.particles);
+        if (count > 0)
+            packet.particleBatches.push_back({&emitter, first, count});
+    }
 
     if (drawPhysics && physics)
+        for (auto &[id, body] : rigidBodies)
+            if (body)
+                packet.physicsShapes.emplace_back().model = physics->getDebugMatrix(body, transforms.getWorldMatrix(id));
+}
+
+void SceneManager::collectModels(FramePacket &packet)
+{
+    // poses were advanced in Update(), the matrices of every animated model go into the packet back to back
+    for (Model &model : models)
     {
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-        physics->Draw(shader);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        if (!model.hasAnimation)
+            continue;
+        const std::vector<glm::mat4> &bones = model.getBoneMatrices();
+        model.paletteOffset = static_cast<unsigned int>(packet.boneMatrices.size());
+        packet.boneMatrices.insert(packet.boneMatrices.end(), bones.begin(), bones.end());
     }
+
+    // occluders first, everything else is tested against their depth below
+    bool occlusionActive = false;
+    if (occlusionCulling)
+    {
+        occlusion.Begin(packet.frame.projection * packet.frame.view);
+        for (Model &model : models)
+        {
+            if (!model.occluder || !model.getAsset()->isReady())
+                continue;
+
+            const glm::mat4 &world = transforms.getWorldMatrix(model.ID);
+            for (const OccluderMesh &mesh : model.getAsset()->occluderMeshes)
+                occlusion.AddOccluder(mesh.positions.data(), mesh.indices.data(), mesh.indices.size(), world);
+        }
+        occlusionActive = occlusion.getTriangleCount() > 0;
+        if (occlusionActive)
+            occlusion.Rasterize(&jobs);
+    }
+
+    // the tree rejects whole models first, only the ones it returns get the per-mesh tests
+    if (frustumCulling)
+    {
+        inFrustum.assign(spatialProxies.size(), 0);
+        spatial.query(frustum, [&](uint32_t nodeID)
+                      {
+                          inFrustum[nodeID] = 1;
+                          return true; });
+    }
+
+    cullStats = {};
+    for (Model &model : models)
+    {
+        drawMeshes.clear();
+        bool skinned = model.collectMeshes(drawMeshes);
+
+        // proxies still sized for a placeholder can be too small, those models take the per-mesh path
+        if (frustumCulling && model.ID < spatialProxies.size() && spatialProxies[model.ID].settled &&
+            !inFrustum[model.ID])
+        {
+            cullStats.culled += static_cast<unsigned int>(drawMeshes.size());
+            continue;
+        }
+
+        const glm::mat4 &world = transforms.getWorldMatrix(model.ID);
+        ModelDraw draw;
+        draw.draw.setTransform(world, transforms.getNormalMatrix(model.ID));
+        draw.draw.instance.boneOffset = skinned ? static_cast<int>(model.paletteOffset) : -1;
+
+        for (Mesh *mesh : drawMeshes)
+        {
+            // the sphere is the cheap reject, the box only runs for what survives it
+            AABB worldBounds = mesh->bounds.transformed(world);
+            if (frustumCulling && (!frustum.testSphere(mesh->sphere.transformed(world)) ||
+                                   !frustum.testAABB(worldBounds)))
+            {
+                cullStats.culled++;
+                continue;
+            }
+            if (occlusionActive && !model.occluder && !occlusion.isVisible(worldBounds))
+            {
+                cullStats.occluded++;
+                continue;
+            }
+            cullStats.visible++;
+
+            draw.draw.mesh = mesh;
+            draw.shaderFeatures = mesh->shaderFeatures | (skinned ? uint32_t(SHADER_SKINNED) : 0u);
+            packet.modelDraws.push_back(draw);
+        }
+    }
+}
+
+void SceneManager::BeginFrame(FramePacket &packet)
+{
+    // the segment written this frame must be free before anything allocates from it
+    stream.BeginFrame();
+
+    uploadFrameData(packet.frame);
+    uploadLightData(packet.lightClusters);
+
+    // all skinning matrices in one stream allocation, the draws hold offsets relative to the packet
+    paletteBase = 0;
+    if (bonePalette.Begin(stream, packet.boneMatrices.size()))
+    {
+        paletteBase = bonePalette.Append(packet.boneMatrices);
+        bonePalette.End(stream);
+    }
+    bonePalette.Bind(BONE_PALETTE_UNIT);
+}
+
+void SceneManager::uploadFrameData(const FrameData &data)
+{
+    if (!frameUBO)
+        frameUBO = std::make_unique<UniformBuffer>(sizeof(FrameData), FRAME_DATA_BINDING);
+    else if (std::memcmp(&data, &lastFrameData, sizeof(FrameData)) == 0)
+        return;
+
+    frameUBO->SetData(&data, sizeof(FrameData));
+    lastFrameData = data;
+}
+
+void SceneManager::uploadLightData(LightClusters &clusters)
+{
+    LightData data;
+    clusters.Upload(stream, data);
+    clusters.Bind();
+
+    if (!lightUBO)
+        lightUBO = std::make_unique<UniformBuffer>(sizeof(LightData), LIGHT_DATA_BINDING);
+    else if (std::memcmp(&data, &lastLightData, sizeof(LightData)) == 0)
+        return;
+
+    lightUBO->SetData(&data, sizeof(LightData));
+    lastLightData = data;
+}
+
+void SceneManager::RenderModels(const FramePacket &packet, const std::string &shaderName)
+{
+    // lights, the camera and the bone palette were bound by BeginFrame()
+
+    // variants are looked up once per feature combination and frame, samplers are program state.
+    // one that is still compiling is drawn with the fallback program meanwhile
+    const uint32_t sceneFeatures = packet.lightClusters.hasClusteredLights() ? uint32_t(SHADER_CLUSTERED_LIGHTS) : 0u;
+    Shader *variants[1 << SHADER_FEATURE_COUNT] = {};
+    auto variantFor = [&](uint32_t features) -> Shader *
+    {
+        Shader *&variant = variants[features];
+        if (!variant)
+        {
+            variant = sm->findVariantIfReady(shaderName, features);
+            if (!variant)
+                variant = &sm->findShader(FALLBACK_SHADER);
+            variant->use();
+            variant->setInt(variant->getUniformLocation("bonePalette"), BONE_PALETTE_UNIT);
+            variant->setInt(variant->getUniformLocation("lightData"), LIGHT_DATA_UNIT);
+            variant->setInt(variant->getUniformLocation("clusterRanges"), CLUSTER_RANGE_UNIT);
+            variant->setInt(variant->getUniformLocation("lightIndices"), LIGHT_INDEX_UNIT);
+        }
+        return variant;
+    };
+
+    // copies of the same mesh are merged into instanced draws by the queue
+    renderQueue.Begin(glm::vec3(packet.frame.camPos));
+    for (const ModelDraw &model : packet.modelDraws)
+    {
+        DrawPacket draw = model.draw;
+        if (draw.instance.boneOffset >= 0)
+            draw.instance.boneOffset += static_cast<int>(paletteBase);
+        draw.shader = variantFor(sceneFeatures | model.shaderFeatures);
+        renderQueue.Submit(draw);
+    }
+    renderQueue.Flush(stream);
+}
+
+void SceneManager::RenderDeferredLighting(const FramePacket &packet, const std::string &shaderName, GBuffer &gbuffer)
+{
+    gbuffer.BindTextures();
+    // a single full screen draw, so this one is waited for instead of falling back
+    Shader &shader = sm->findVariant(shaderName, packet.lightClusters.hasClusteredLights() ? uint32_t(SHADER_CLUSTERED_LIGHTS) : 0u);
+    shader.use();
+    shader.setInt(shader.getUniformLocation("gAlbedoSpecular"), GBUFFER_ALBEDO_UNIT);
+    shader.setInt(shader.getUniformLocation("gNormal"), GBUFFER_NORMAL_UNIT);
+    shader.setInt(shader.getUniformLocation("gDepth"), GBUFFER_DEPTH_UNIT);
+    shader.setInt(shader.getUniformLocation("lightData"), LIGHT_DATA_UNIT);
+    shader.setInt(shader.getUniformLocation("clusterRanges"), CLUSTER_RANGE_UNIT);
+    shader.setInt(shader.getUniformLocation("lightIndices"), LIGHT_INDEX_UNIT);
+    shader.setMat4(shader.getUniformLocation("inverseViewProjection"), glm::inverse(packet.frame.projection * packet.frame.view));
+
+    // every pixel passes, the shader writes the G-buffer depth for the passes after it
+    glDepthFunc(GL_ALWAYS);
+    gbuffer.DrawFullscreen();
+    glDepthFunc(GL_LESS);
+}
+
+void SceneManager::RenderLights(const FramePacket &packet, Shader &shader)
+{
+    if (!gizmoCube)
+        gizmoCube = std::make_unique<Mesh>(MeshType::CUBE);
+
+    // all gizmos share one cube, so this is a single instanced draw
+    renderQueue.Begin(glm::vec3(packet.frame.camPos));
+    for (const InstanceData &gizmo : packet.lightGizmos)
+    {
+        DrawPacket draw;
+        draw.mesh = gizmoCube.get();
+        draw.shader = &shader;
+        draw.instance = gizmo;
+        renderQueue.Submit(draw);
+    }
+    renderQueue.Flush(stream);
+}
+
+void SceneManager::RenderParticles(const FramePacket &packet)
+{
+    for (const ParticleBatch &batch : packet.particleBatches)
+        batch.emitter->Draw(stream, packet.particles.data() + batch.first, batch.count);
+    GLState::SetBlend(false);
+}
+
+void SceneManager::RenderPhysics(const FramePacket &packet, Shader &shader)
+{
+    GLState::PolygonMode(GL_LINE);
+    renderQueue.Begin(glm::vec3(packet.frame.camPos));
+    for (const InstanceData &shape : packet.physicsShapes)
+    {
+        DrawPacket draw;
+        // only created together with the first rigid body, which happens between frames
+        draw.mesh = &physics->debugMesh;
+        draw.shader = &shader;
+        draw.instance = shape;
+        renderQueue.Submit(draw);
+    }
+    renderQueue.Flush(stream);
+    GLState::PolygonMode(GL_FILL);
+}
+
+void SceneManager::EndFrame()
+{
+    renderQueue.EndFrame();
+    stream.EndFrame();
+
+    std::lock_guard<std::mutex> lock(statsMutex);
+    frameStats.sorted = renderQueue.getStats();
+    frameStats.unsorted = renderQueue.getUnsortedStats();
+    frameStats.glState = GLState::getStats();
+    frameStats.countingGLState = GLState::IsCounting();
+    frameStats.compilingShaders = sm ? sm->compilingCount() : 0;
+}
+
+FrameStats SceneManager::getFrameStats() const
+{
+    std::lock_guard<std::mutex> lock(statsMutex);
+    return frameStats;
 }
 
 void SceneManager::deleteNode(unsigned int ID)
@@ -261,31 +609,23 @@ void SceneManager::deleteNode(unsigned int ID)
         return;
     }
 
-    if (nodeToDelete->parent)
-    {
-        auto &siblings = nodeToDelete->parent->children;
-        siblings.erase(std::remove(siblings.begin(), siblings.end(), nodeToDelete), siblings.end());
-    }
+    Node *newParent = nodeToDelete->parent;
+    nodeToDelete->detach();
 
-    if (!nodeToDelete->children.empty())
+    while (Node *childern = nodeToDelete->firstChild)
     {
-        for (auto &childern : nodeToDelete->children)
-        {
-            childern->parent = nodeToDelete->parent;
-            nodeToDelete->parent->children.push_back(childern);
-        }
-
-        nodeToDelete->children.clear();
+        newParent->appendChild(childern);
+        transforms.setParent(childern->ID, newParent->ID);
     }
 
     if (nodeToDelete->type == NodeType::Model)
     {
-        auto it = std::find_if(models.begin(), models.end(), [&](const Model &m)
-                               { return m.ID == nodeToDelete->ID; });
-        if (it != models.end())
+        Model *model = models.get(nodeToDelete->component);
+        if (model)
         {
-            std::cout << "[SceneManager] Deleting model with ID: " << it->ID << " and path: " << it->directory << std::endl;
-            models.erase(it);
+            std::cout << "[SceneManager] Deleting model with ID: " << model->ID << " and path: " << model->directory << std::endl;
+            models.erase(nodeToDelete->component);
+            assets.releaseUnused();
         }
         else
         {
@@ -295,29 +635,27 @@ void SceneManager::deleteNode(unsigned int ID)
 
     if (nodeToDelete->type == NodeType::Light)
     {
-        auto it = std::find_if(lights.begin(), lights.end(), [&](const Light &m)
-                               { return m.ID == nodeToDelete->ID; });
-        if (it != lights.end())
+        Light *light = lights.get(nodeToDelete->component);
+        if (light)
         {
-            std::cout << "[SceneManager] Deleting Light with ID: " << it->ID << std::endl;
-            lights.erase(it);
+            std::cout << "[SceneManager] Deleting Light with ID: " << light->ID << std::endl;
+            lights.erase(nodeToDelete->component);
         }
         else
             std::cerr << "[SceneManager] Warning: No Light found for node ID " << nodeToDelete->ID << std::endl;
     }
     if (nodeToDelete->type == NodeType::Particles)
     {
-        if (!nodeToDelete->children.empty())
+        if (nodeToDelete->hasChildren())
         {
-            deleteNode(nodeToDelete->children[0]->ID);
+            deleteNode(nodeToDelete->firstChild->ID);
         }
-        auto it = std::find_if(particleEmitters.begin(), particleEmitters.end(), [&](const ParticleEmitter &m)
-                               { return m.ID == nodeToDelete->ID; });
-        if (it != particleEmitters.end())
+        ParticleEmitter *emitter = particleEmitters.get(nodeToDelete->component);
+        if (emitter)
         {
-            std::cout << "[SceneManager] Deleting Particle Emitter with ID: " << it->ID << std::endl;
-            // deleteNode(nodeToDelete->children[0]->ID);
-            particleEmitters.erase(it);
+            std::cout << "[SceneManager] Deleting Particle Emitter with ID: " << emitter->ID << std::endl;
+            // deleteNode(nodeToDelete->firstChild->ID);
+            particleEmitters.erase(nodeToDelete->component);
         }
         else
             std::cerr << "[SceneManager] Warning: No Particle Emitter found for node ID " << nodeToDelete->ID << std::endl;
@@ -336,32 +674,34 @@ void SceneManager::deleteNode(unsigned int ID)
     }
 
     std::cout << "[SceneManager] Deleting node with ID: " << nodeToDelete->ID << " and name: " << nodeToDelete->name << std::endl;
-    nodes.erase(std::remove(nodes.begin(), nodes.end(), nodeToDelete), nodes.end());
-    delete nodeToDelete;
+    nodes[nodeToDelete->ID] = nullptr;
+    transforms.remove(nodeToDelete->ID);
+    removeProxy(nodeToDelete->ID);
+    nodePool.destroy(nodeToDelete);
 }
 
 Model *SceneManager::getModelByID(unsigned int ID)
 {
-    for (Model &model : models)
-        if (model.ID == ID)
-            return &model;
-    return nullptr;
+    Node *node = find_node(ID);
+    if (!node || node->type != NodeType::Model)
+        return nullptr;
+    return models.get(node->component);
 }
 
 Light *SceneManager::getLightByID(unsigned int ID)
 {
-    for (Light &light : lights)
-        if (light.ID == ID)
-            return &light;
-    return nullptr;
+    Node *node = find_node(ID);
+    if (!node || node->type != NodeType::Light)
+        return nullptr;
+    return lights.get(node->component);
 }
 
 ParticleEmitter *SceneManager::getEmitterByID(unsigned int ID)
 {
-    for (ParticleEmitter &emitter : particleEmitters)
-        if (emitter.ID == ID)
-            return &emitter;
-    return nullptr;
+    Node *node = find_node(ID);
+    if (!node || node->type != NodeType::Particles)
+        return nullptr;
+    return particleEmitters.get(node->component);
 }
 
 btRigidBody *SceneManager::getRigidBodyByID(unsigned int ID)
@@ -390,25 +730,33 @@ void SceneManager::saveScene()
         j["name"] = node->name;
         j["type"] = nodeTypeToString(node->type);
 
+        if (node != root)
+        {
+            glm::vec3 position = transforms.getPosition(node->ID);
+            glm::vec3 rotation = transforms.getRotation(node->ID);
+            glm::vec3 scale = transforms.getScale(node->ID);
+            j["position"] = {position.x, position.y, position.z};
+            j["rotation"] = {rotation.x, rotation.y, rotation.z};
+            j["scale"] = {scale.x, scale.y, scale.z};
+        }
+
         // Save model-specific data
         if (node->type == NodeType::Model)
         {
-            auto it = std::find_if(models.begin(), models.end(), [&](const Model &m)
-                                   { return m.ID == node->ID; });
+            Model *it = models.get(node->component);
 
-            if (it != models.end())
+            if (it)
             {
                 if (!it->directory.empty())
                 {
                     j["modelPath"] = it->directory;
+                    if (it->occluder)
+                        j["occluder"] = true;
                 }
                 else
                 {
                     std::cerr << "[SceneManager] Warning: Model with ID " << node->ID << " has empty directory." << std::endl;
                 }
-                j["position"] = {it->getPosition().x, it->getPosition().y, it->getPosition().z};
-                j["rotation"] = {it->getRotation().x, it->getRotation().y, it->getRotation().z};
-                j["scale"] = {it->getScale().x, it->getScale().y, it->getScale().z};
             }
             else
             {
@@ -419,13 +767,13 @@ void SceneManager::saveScene()
         // Save light-specific data
         else if (node->type == NodeType::Light)
         {
-            auto it = std::find_if(lights.begin(), lights.end(), [&](const Light &l)
-                                   { return l.ID == node->ID; });
+            Light *it = lights.get(node->component);
 
-            if (it != lights.end())
+            if (it)
             {
                 j["color"] = {it->color.x, it->color.y, it->color.z};
-                j["position"] = {it->position.x, it->position.y, it->position.z};
+                j["radius"] = it->radius;
+                j["lightType"] = static_cast<int>(it->type);
             }
             else
             {
@@ -435,13 +783,11 @@ void SceneManager::saveScene()
 
         else if (node->type == NodeType::Particles)
         {
-            auto it = std::find_if(particleEmitters.begin(), particleEmitters.end(), [&](const ParticleEmitter &p)
-                                   { return p.ID == node->ID; });
+            ParticleEmitter *it = particleEmitters.get(node->component);
 
-            if (it != particleEmitters.end())
+            if (it)
             {
                 j["color"] = {it->Color.r, it->Color.g, it->Color.b, it->Color.a};
-                j["position"] = {it->Position.x, it->Position.y, it->Position.z};
                 j["shdaerName"] = it->shader.Name;
                 j["maxParticles"] = it->maxParticles;
             }
@@ -452,10 +798,10 @@ void SceneManager::saveScene()
         }
 
         // Recurse into children
-        if (!node->children.empty())
+        if (node->hasChildren())
         {
             j["children"] = json::array();
-            for (Node *child : node->children)
+            for (Node *child = node->firstChild; child; child = child->nextSibling)
             {
                 j["children"].push_back(buildNodeJson(child));
             }
@@ -516,15 +862,26 @@ void SceneManager::LoadScene(const std::string &path)
     projectName = data.value("projectName", "UnnamedProject");
 
     // Cleanup
-    for (Node *node : nodes)
-    {
-        delete node;
-    }
+    nodePool.reset();
     nodes.clear();
     models.clear();
     lights.clear(); // Add this if lights are persistent
+    particleEmitters.clear();
+    transforms.clear();
+    spatial.clear();
+    spatialProxies.clear();
     nextID = 1;
 
+    auto applyTransform = [&](json &j, unsigned int id)
+    {
+        if (j.contains("position"))
+            transforms.setPosition(id, glm::vec3(j["position"][0], j["position"][1], j["position"][2]));
+        if (j.contains("rotation"))
+            transforms.setRotation(id, glm::vec3(j["rotation"][0], j["rotation"][1], j["rotation"][2]));
+        if (j.contains("scale"))
+            transforms.setScale(id, glm::vec3(j["scale"][0], j["scale"][1], j["scale"][2]));
+    };
+
     std::function<void(json &, Node *)> buildNodeRecursive = [&](json &j, Node *parent)
     {
         unsigned int id = j["id"];
@@ -536,32 +893,26 @@ void SceneManager::LoadScene(const std::string &path)
             std::string modelPath = j["modelPath"];
             addToParent(name, modelPath, type, parent->ID);
 
-            // Set model transform if available
-            auto *model = getModelByID(id);
-            if (model)
-            {
-                if (j.contains("position"))
-                    model->setPosition(glm::vec3(j["position"][0], j["position"][1], j["position"][2]));
-                if (j.contains("rotation"))
-                    model->setRotation(glm::vec3(j["rotation"][0], j["rotation"][1], j["rotation"][2]));
-                if (j.contains("scale"))
-                    model->setScale(glm::vec3(j["scale"][0], j["scale"][1], j["scale"][2]));
-            }
+            Model *model = getModelByID(id);
+            if (model && j.contains("occluder"))
+                model->occluder = j["occluder"];
         }
         else if (type == NodeType::Light)
         {
             if (parent->type == NodeType::Particles)
                 return;
-            addToParent(name, type, parent->ID, LightType::DIRECTIONAL);
+            // scenes saved before light types were stored only had directional lights
+            LightType lightType = j.contains("lightType") ? static_cast<LightType>(j["lightType"].get<int>()) : LightType::DIRECTIONAL;
+            addToParent(name, type, parent->ID, lightType);
 
             // Set light data if available
             auto *light = getLightByID(id);
             if (light)
             {
-                if (j.contains("position"))
-                    light->position = glm::vec3(j["position"][0], j["position"][1], j["position"][2]);
                 if (j.contains("color"))
                     light->color = glm::vec3(j["color"][0], j["color"][1], j["color"][2]);
+                if (j.contains("radius"))
+                    light->radius = j["radius"];
             }
         }
         else if (type == NodeType::Particles)
@@ -579,8 +930,6 @@ void SceneManager::LoadScene(const std::string &path)
             auto *emitter = getEmitterByID(id);
             if (emitter)
             {
-                if (j.contains("position"))
-                    emitter->Position = glm::vec3(j["position"][0], j["position"][1], j["position"][2]);
                 if (j.contains("color"))
                     emitter->Color = glm::vec4(j["color"][0], j["color"][1], j["color"][2], j["color"][3]);
             }
@@ -590,6 +939,8 @@ void SceneManager::LoadScene(const std::string &path)
             addToParent(name, type, parent->ID);
         }
 
+        applyTransform(j, id);
+
         // Recurse into children
         if (j.contains("children"))
         {
@@ -606,8 +957,8 @@ void SceneManager::LoadScene(const std::string &path)
     std::string rootName = rootJson["name"];
     NodeType rootType = stringToNodeType(rootJson["type"]);
 
-    root = new Node{rootID, rootName, rootType, nullptr, {}};
-    nodes.push_back(root);
+    root = nodePool.create(rootID, rootName, rootType);
+    registerNode(root);
     nextID = std::max(nextID, rootID + 1);
 
     if (rootJson.contains("children"))
@@ -618,6 +969,9 @@ void SceneManager::LoadScene(const std::string &path)
         }
     }
 
+    // assets of the previous scene that the new one did not pick up again
+    assets.releaseUnused();
+
     std::cout << "[SceneManager] Scene loaded successfully." << std::endl;
 }
 
@@ -632,11 +986,17 @@ Node *SceneManager::find_node(unsigned int id)
         return nullptr;
     }
 
-    for (Node *node : nodes)
-    {
-        if (node->ID == id)
-            return node;
-    }
+    if (id >= nodes.size())
+        return nullptr;
 
-    return nullptr;
+    return nodes[id];
+}
+
+void SceneManager::registerNode(Node *node)
+{
+    if (node->ID >= nodes.size())
+        nodes.resize(node->ID + 1, nullptr);
+    nodes[node->ID] = node;
+
+    transforms.add(node->ID, node->parent ? node->parent->ID : TransformStore::NONE);
 }
\ No newline at end of file
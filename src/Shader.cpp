@@ -1,47 +1,44 @@
 #include "Shader.h"
+#include "UniformBlocks.h"
+#include "GLState.h"
+#include "ShaderCache.h"
+#include "GLExtensions.h"
 
 using namespace std;
 
-Shader::Shader(const char *Name, const char *vertex_shader_src, const char *fragment_shader_src)
+const char *shaderFeatureName(uint32_t feature)
 {
-    this->Name = Name;
-    ifstream vFile(vertex_shader_src);
-    ifstream fFile(fragment_shader_src);
-    if (!vFile.is_open() || !fFile.is_open())
+    switch (feature)
     {
-        cerr << "[Shader - ERROR] Failed to open shader file(s)." << endl;
-        return;
+    case SHADER_SKINNED:
+        return "SKINNED";
+    case SHADER_TEXTURED:
+        return "TEXTURED";
+    case SHADER_CLUSTERED_LIGHTS:
+        return "CLUSTERED_LIGHTS";
+    default:
+        return "UNKNOWN_FEATURE";
     }
+}
 
-    stringstream vStream, fStream;
-
-    vStream << vFile.rdbuf();
-    fStream << fFile.rdbuf();
-
-    std::string vCode = vStream.str();
-    std::string fCode = fStream.str();
-    const char *vShaderCode = vCode.c_str();
-    const char *fShaderCode = fCode.c_str();
-
-    vertexShaderID = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShaderID, 1, &vShaderCode, NULL);
-    glCompileShader(vertexShaderID);
-
-    Shader::checkCompileErrors(vertexShaderID, "Shader");
-
-    fragmentShaderID = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShaderID, 1, &fShaderCode, NULL);
-    glCompileShader(fragmentShaderID);
-
-    Shader::checkCompileErrors(fragmentShaderID, "Shader");
-
-    // cout << "[Shader] Shader program with vert shader at " << vertex_shader_src << " and fragment shader at " << fragment_shader_src << " was loaded! Waiting to create program." << endl;
+Shader::Shader(const char *Name, const char *vertex_shader_src, const char *fragment_shader_src, const std::string &defines)
+    : defines(defines)
+{
+    this->Name = Name;
+    readSources(vertex_shader_src, fragment_shader_src);
+    insertDefines(vertexSource);
+    insertDefines(fragmentSource);
 }
 
 Shader::Shader(const char *vertex_shader_src, const char *fragment_shader_src)
 {
-    ifstream vFile(vertex_shader_src);
-    ifstream fFile(fragment_shader_src);
+    readSources(vertex_shader_src, fragment_shader_src);
+}
+
+void Shader::readSources(const char *vertex_path, const char *fragment_path)
+{
+    ifstream vFile(vertex_path);
+    ifstream fFile(fragment_path);
     if (!vFile.is_open() || !fFile.is_open())
     {
         cerr << "[Shader - ERROR] Failed to open shader file(s)." << endl;
@@ -53,40 +50,111 @@ Shader::Shader(const char *vertex_shader_src, const char *fragment_shader_src)
     vStream << vFile.rdbuf();
     fStream << fFile.rdbuf();
 
-    std::string vCode = vStream.str();
-    std::string fCode = fStream.str();
-    const char *vShaderCode = vCode.c_str();
-    const char *fShaderCode = fCode.c_str();
+    vertexSource = vStream.str();
+    fragmentSource = fStream.str();
+}
+
+void Shader::insertDefines(std::string &source) const
+{
+    if (defines.empty())
+        return;
+
+    // #version has to stay the first statement
+    size_t version = source.find("#version");
+    size_t lineEnd = version == std::string::npos ? std::string::npos : source.find('\n', version);
+    if (lineEnd == std::string::npos)
+        source.insert(0, defines);
+    else
+        source.insert(lineEnd + 1, defines);
+}
 
+void Shader::compile()
+{
+    const char *vShaderCode = vertexSource.c_str();
+    const char *fShaderCode = fragmentSource.c_str();
+
+    // no status queries here, they would wait for the driver. finish() reports the errors
     vertexShaderID = glCreateShader(GL_VERTEX_SHADER);
     glShaderSource(vertexShaderID, 1, &vShaderCode, NULL);
     glCompileShader(vertexShaderID);
 
-    Shader::checkCompileErrors(vertexShaderID, "Shader");
-
     fragmentShaderID = glCreateShader(GL_FRAGMENT_SHADER);
     glShaderSource(fragmentShaderID, 1, &fShaderCode, NULL);
     glCompileShader(fragmentShaderID);
+}
 
-    Shader::checkCompileErrors(fragmentShaderID, "Shader");
+void Shader::createProgram(ShaderCache *cache, const std::string &cacheName)
+{
+    submit(cache, cacheName);
+    finish();
+}
+
+void Shader::submit(ShaderCache *cache, const std::string &cacheName)
+{
+    this->cache = cache;
+    this->cacheName = cacheName;
+    ready = false;
+    cached = false;
+    if (cache && cache->isEnabled())
+    {
+        cacheKey = cache->key(vertexSource, fragmentSource, defines);
+        ID = cache->load(cacheName, cacheKey);
+        cached = ID != 0;
+    }
+
+    if (!cached)
+    {
+        compile();
+
+        ID = glCreateProgram();
+        glAttachShader(ID, vertexShaderID);
+        glAttachShader(ID, fragmentShaderID);
+        if (cache)
+            cache->prepare(ID);
+        glLinkProgram(ID);
+    }
+}
 
-    // cout << "[Shader] Shader program with vert shader at " << vertex_shader_src << " and fragment shader at " << fragment_shader_src << " was loaded! Waiting to create program." << endl;
+bool Shader::isLinkDone() const
+{
+    if (cached || !GLExtensions::parallelShaderCompile)
+        return true;
+    int done = 0;
+    glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &done);
+    return done != 0;
 }
 
-void Shader::createProgram()
+void Shader::finish()
 {
-    ID = glCreateProgram();
-    glAttachShader(ID, vertexShaderID);
-    glAttachShader(ID, fragmentShaderID);
-    glLinkProgram(ID);
+    if (ready)
+        return;
 
-    Shader::checkCompileErrors(ID, "Program");
+    if (!cached)
+    {
+        Shader::checkCompileErrors(vertexShaderID, "Shader");
+        Shader::checkCompileErrors(fragmentShaderID, "Shader");
+        Shader::checkCompileErrors(ID, "Program");
+
+        // delete the shaders as they're linked to the program now
+        glDeleteShader(vertexShaderID);
+        glDeleteShader(fragmentShaderID);
+
+        int linked = 0;
+        glGetProgramiv(ID, GL_LINK_STATUS, &linked);
+        if (cache && linked)
+            cache->store(cacheName, cacheKey, ID);
+    }
 
-    // cout << "Shader program: " << Name << " created.";
+    // block bindings are not part of the binary, so they are set either way
+    reflectUniforms();
+    bindUniformBlocks();
 
-    // delete the shaders as they're linked to the program now
-    glDeleteShader(vertexShaderID);
-    glDeleteShader(fragmentShaderID);
+    // the sources are only needed to build the program
+    vertexSource.clear();
+    vertexSource.shrink_to_fit();
+    fragmentSource.clear();
+    fragmentSource.shrink_to_fit();
+    ready = true;
 }
 
 void Shader::checkCompileErrors(unsigned int id, const char *type)
@@ -118,14 +186,89 @@ void Shader::checkCompileErrors(unsigned int id, const char *type)
     }
 }
 
+void Shader::reflectUniforms()
+{
+    uniforms.clear();
+
+    int count = 0, maxNameLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+
+    std::string name(maxNameLength, '\0');
+    for (int i = 0; i < count; i++)
+    {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, i, maxNameLength, &length, &size, &type, &name[0]);
+
+        // arrays are reported as "name[0]"
+        std::string baseName = name.substr(0, length);
+        bool isArray = baseName.size() > 3 && baseName.compare(baseName.size() - 3, 3, "[0]") == 0;
+        if (isArray)
+            baseName.resize(baseName.size() - 3);
+
+        int location = glGetUniformLocation(ID, baseName.c_str());
+        if (location == -1)
+            continue; // lives in a uniform block
+
+        uniforms.add(baseName, {location, type, size});
+        if (isArray)
+        {
+            for (int element = 0; element < size; element++)
+            {
+                std::string elementName = baseName + "[" + std::to_string(element) + "]";
+                uniforms.add(elementName, {glGetUniformLocation(ID, elementName.c_str()), type, 1});
+            }
+        }
+    }
+}
+
+void Shader::bindUniformBlocks()
+{
+    // blocks a program does not declare (or the compiler dropped) are simply skipped
+    const std::pair<const char *, unsigned int> blocks[] = {
+        {"FrameData", FRAME_DATA_BINDING},
+        {"LightData", LIGHT_DATA_BINDING},
+    };
+
+    for (const auto &[name, binding] : blocks)
+    {
+        unsigned int index = glGetUniformBlockIndex(ID, name);
+        if (index != GL_INVALID_INDEX)
+            glUniformBlockBinding(ID, index, binding);
+    }
+}
+
 void Shader::use()
 {
-    glUseProgram(ID);
+    GLState::UseProgram(ID);
+}
+
+void Shader::setInt(int location, int value) { glUniform1i(location, value); }
+void Shader::setBool(int location, bool value) { glUniform1i(location, value ? 1 : 0); }
+void Shader::setFloat(int location, float value) { glUniform1f(location, value); }
+void Shader::setVec2(int location, const glm::vec2 &value) { glUniform2fv(location, 1, &value[0]); }
+void Shader::setVec3(int location, const glm::vec3 &value) { glUniform3fv(location, 1, &value[0]); }
+void Shader::setVec4(int location, const glm::vec4 &value) { glUniform4fv(location, 1, &value[0]); }
+void Shader::setMat3(int location, const glm::mat3 &value) { glUniformMatrix3fv(location, 1, GL_FALSE, &value[0][0]); }
+void Shader::setMat4(int location, const glm::mat4 &value) { glUniformMatrix4fv(location, 1, GL_FALSE, &value[0][0]); }
+
+void Shader::setVec3Array(int location, const glm::vec3 *values, int count)
+{
+    if (count > 0)
+        glUniform3fv(location, count, &values[0][0]);
+}
+
+void Shader::setMat4Array(int location, const glm::mat4 *values, int count)
+{
+    if (count > 0)
+        glUniformMatrix4fv(location, count, GL_FALSE, &values[0][0][0]);
 }
 
 void Shader::setUniforms(const char *uName, unsigned int type, void *value)
 {
-    int location = glGetUniformLocation(ID, uName);
+    int location = uniforms.getLocation(uName);
     if (location == -1)
     {
         cerr << "[Shader - ERROR] Uniform '" << uName << "' not found." << endl;
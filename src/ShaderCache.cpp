@@ -0,0 +1,162 @@
+#include "ShaderCache.h"
+#include "GLExtensions.h"
+
+#include <iostream>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <filesystem>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    const char SHADER_CACHE_MAGIC[4] = {'F', 'X', 'P', 'B'};
+    constexpr uint32_t SHADER_CACHE_VERSION = 1;
+
+    struct ShaderCacheHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t key;
+        uint32_t format; // driver specific binary format
+        uint32_t length;
+    };
+
+    // FNV-1a, 64 bit
+    uint64_t hashBytes(uint64_t hash, const std::string &bytes)
+    {
+        for (unsigned char c : bytes)
+        {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        // a separator, so moving text from one source to the next changes the key
+        hash ^= 0xFF;
+        hash *= 1099511628211ull;
+        return hash;
+    }
+
+    std::string glString(GLenum name)
+    {
+        const char *value = reinterpret_cast<const char *>(glGetString(name));
+        return value ? value : "";
+    }
+}
+
+ShaderCache::ShaderCache(const std::string &directory) : directory(directory) {}
+
+bool ShaderCache::isEnabled() const
+{
+    return GLExtensions::programBinary;
+}
+
+std::string ShaderCache::pathOf(const std::string &name) const
+{
+    return directory + "/" + name + ".bin";
+}
+
+uint64_t ShaderCache::key(const std::string &vertexSource, const std::string &fragmentSource, const std::string &defines)
+{
+    if (driver.empty())
+        driver = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" + glString(GL_VERSION);
+
+    uint64_t hash = 14695981039346656037ull;
+    hash = hashBytes(hash, driver);
+    hash = hashBytes(hash, defines);
+    hash = hashBytes(hash, vertexSource);
+    hash = hashBytes(hash, fragmentSource);
+    return hash;
+}
+
+void ShaderCache::prepare(unsigned int program)
+{
+    if (isEnabled())
+        GLExtensions::ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+unsigned int ShaderCache::load(const std::string &name, uint64_t key)
+{
+    if (!isEnabled())
+        return 0;
+
+    std::ifstream in(pathOf(name), std::ios::binary);
+    if (!in)
+        return 0;
+
+    ShaderCacheHeader header{};
+    if (!in.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, SHADER_CACHE_MAGIC, 4) != 0 ||
+        header.version != SHADER_CACHE_VERSION || header.key != key || header.length == 0)
+        return 0;
+
+    std::vector<char> binary(header.length);
+    if (!in.read(binary.data(), binary.size()))
+        return 0;
+
+    unsigned int program = glCreateProgram();
+    GLExtensions::ProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    GLint linked = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked)
+    {
+        std::cerr << "[ShaderCache] Driver rejected the cached binary of " << name << ", recompiling." << std::endl;
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+void ShaderCache::store(const std::string &name, uint64_t key, unsigned int program)
+{
+    if (!isEnabled())
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    ShaderCacheHeader header{};
+    std::memcpy(header.magic, SHADER_CACHE_MAGIC, 4);
+    header.version = SHADER_CACHE_VERSION;
+    header.key = key;
+
+    std::vector<char> binary(length);
+    GLsizei written = 0;
+    GLenum format = 0;
+    GLExtensions::GetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0)
+        return;
+    header.format = format;
+    header.length = static_cast<uint32_t>(written);
+
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+
+    // written next to the target and renamed, a crash never leaves half a binary behind
+    const std::string path = pathOf(name), tempPath = path + ".tmp";
+    bool saved = false;
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        saved = out.write(reinterpret_cast<const char *>(&header), sizeof(header)) &&
+                out.write(binary.data(), header.length);
+    }
+    if (!saved)
+    {
+        std::cerr << "[ShaderCache] Could not write " << tempPath << std::endl;
+        fs::remove(tempPath, ec);
+        return;
+    }
+
+    // rename does not replace an existing file everywhere (older MinGW)
+    fs::remove(path, ec);
+    fs::rename(tempPath, path, ec);
+    if (ec)
+    {
+        std::cerr << "[ShaderCache] Could not write " << path << ": " << ec.message() << std::endl;
+        fs::remove(tempPath, ec);
+    }
+}
@@ -0,0 +1,159 @@
+#include "ShaderCompiler.h"
+#include "ShaderCache.h"
+#include "GLExtensions.h"
+
+#include <iostream>
+
+ShaderCompiler::~ShaderCompiler()
+{
+    Shutdown();
+}
+
+void ShaderCompiler::Init()
+{
+    if (GLExtensions::parallelShaderCompile)
+    {
+        // let the driver use as many threads as it likes
+        GLExtensions::MaxShaderCompilerThreads(0xFFFFFFFF);
+        mode = CompileMode::Parallel;
+    }
+    else if (GLFWwindow *mainContext = glfwGetCurrentContext())
+    {
+        // same context hints as the main window are still set, only hide this one
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        workerContext = glfwCreateWindow(1, 1, "FYNiX shader compiler", nullptr, mainContext);
+        glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+        if (workerContext)
+        {
+            mode = CompileMode::Worker;
+            worker = std::thread(&ShaderCompiler::workerLoop, this);
+        }
+        else
+            std::cerr << "[ShaderCompiler] Could not create a shared context, compiling on the main thread." << std::endl;
+    }
+
+    std::cout << "[ShaderCompiler] Compiling shaders " << getModeName() << "." << std::endl;
+}
+
+void ShaderCompiler::Shutdown()
+{
+    if (worker.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        jobAvailable.notify_all();
+        worker.join();
+    }
+    if (workerContext)
+    {
+        glfwDestroyWindow(workerContext);
+        workerContext = nullptr;
+    }
+}
+
+const char *ShaderCompiler::getModeName() const
+{
+    switch (mode)
+    {
+    case CompileMode::Parallel:
+        return "in parallel (KHR_parallel_shader_compile)";
+    case CompileMode::Worker:
+        return "on a worker thread";
+    default:
+        return "on the main thread";
+    }
+}
+
+void ShaderCompiler::Submit(Shader &shader, ShaderCache *cache, const std::string &name)
+{
+    switch (mode)
+    {
+    case CompileMode::Parallel:
+        shader.submit(cache, name);
+        break;
+    case CompileMode::Worker:
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.push_back({&shader, cache, name});
+            inFlight.insert(&shader);
+        }
+        jobAvailable.notify_one();
+        break;
+    }
+    default:
+        shader.createProgram(cache, name);
+        break;
+    }
+}
+
+bool ShaderCompiler::Poll(Shader &shader)
+{
+    if (mode == CompileMode::Worker)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (inFlight.count(&shader))
+        {
+            if (!finished.erase(&shader))
+                return false;
+            inFlight.erase(&shader);
+            return true;
+        }
+        return shader.ready;
+    }
+
+    if (!shader.ready && shader.isLinkDone())
+        shader.finish();
+    return shader.ready;
+}
+
+void ShaderCompiler::Wait(Shader &shader)
+{
+    if (mode == CompileMode::Worker)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!inFlight.count(&shader))
+            return;
+        jobFinished.wait(lock, [&]
+                         { return finished.count(&shader) != 0; });
+        finished.erase(&shader);
+        inFlight.erase(&shader);
+        return;
+    }
+
+    shader.finish();
+}
+
+void ShaderCompiler::workerLoop()
+{
+    glfwMakeContextCurrent(workerContext);
+
+    while (true)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            jobAvailable.wait(lock, [this]
+                              { return stopping || !queue.empty(); });
+            if (queue.empty())
+                break;
+            job = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        job.shader->createProgram(job.cache, job.name);
+        // the main context only sees the finished program after this
+        glFinish();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished.insert(job.shader);
+        }
+        jobFinished.notify_all();
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
@@ -1,8 +1,27 @@
 #include "ShaderManager.h"
 
+#include <chrono>
+#include <algorithm>
+
+namespace
+{
+    using Clock = std::chrono::high_resolution_clock;
+
+    double elapsedMs(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+}
+
 ShaderManager::ShaderManager()
 {
     std::cout << "[ShaderManager] Initializing Shaders." << std::endl;
+    compiler.Init();
+}
+
+void ShaderManager::Shutdown()
+{
+    compiler.Shutdown();
 }
 
 void ShaderManager::addShader(const std::string &shaderName, const char *vertex_path, const char *fragment_path)
@@ -14,11 +33,138 @@ void ShaderManager::addShader(const std::string &shaderName, const char *vertex_
         return;
     }
 
-    std::cout << "[ShaderManager] Creating shader program with name: " << shaderName << std::endl;
+    build(shaderName, vertex_path, fragment_path, "");
+}
+
+void ShaderManager::addShaderVariants(const std::string &shaderName, const char *vertex_path, const char *fragment_path, uint32_t features)
+{
+    if (variantSets.find(shaderName) != variantSets.end())
+    {
+        std::cerr << "[ShaderManager] Shader variants with name: " << shaderName << " already exist!" << std::endl;
+        return;
+    }
+
+    VariantSet &set = variantSets[shaderName];
+    set.vertexPath = vertex_path;
+    set.fragmentPath = fragment_path;
+    set.features = features;
+
+    // every combination goes to the compiler now, draws pick them up as they finish
+    for (uint32_t mask = 0; mask < (1u << SHADER_FEATURE_COUNT); mask++)
+        if ((mask & features) == mask)
+            buildVariant(shaderName, set, mask);
+}
+
+Shader &ShaderManager::buildVariant(const std::string &shaderName, VariantSet &set, uint32_t features)
+{
+    std::string variantName = shaderName, defines;
+    for (uint32_t bit = 0; bit < SHADER_FEATURE_COUNT; bit++)
+    {
+        if (!(features & (1u << bit)))
+            continue;
+        variantName += std::string("+") + shaderFeatureName(1u << bit);
+        defines += std::string("#define ") + shaderFeatureName(1u << bit) + "\n";
+    }
 
-    // Create the shader directly inside the map to avoid copies
-    shaderMap.emplace(shaderName, Shader(shaderName.c_str(), vertex_path, fragment_path));
-    shaderMap.at(shaderName).createProgram();
+    set.variants[features] = &build(variantName, set.vertexPath.c_str(), set.fragmentPath.c_str(), defines);
+    return *set.variants[features];
+}
+
+ShaderManager::VariantSet &ShaderManager::findVariantSet(const std::string &shaderName)
+{
+    auto it = variantSets.find(shaderName);
+    if (it == variantSets.end())
+    {
+        std::cerr << "[ShaderManager] Shader variants with name: " << shaderName << " not found!" << std::endl;
+        throw std::out_of_range(shaderName);
+    }
+    return it->second;
+}
+
+Shader &ShaderManager::findVariant(const std::string &shaderName, uint32_t features)
+{
+    VariantSet &set = findVariantSet(shaderName);
+    features &= set.features;
+    Shader &shader = set.variants[features] ? *set.variants[features] : buildVariant(shaderName, set, features);
+    wait(shader);
+    return shader;
+}
+
+Shader *ShaderManager::findVariantIfReady(const std::string &shaderName, uint32_t features)
+{
+    VariantSet &set = findVariantSet(shaderName);
+    features &= set.features;
+    Shader &shader = set.variants[features] ? *set.variants[features] : buildVariant(shaderName, set, features);
+    return poll(shader) ? &shader : nullptr;
+}
+
+Shader &ShaderManager::build(const std::string &shaderName, const char *vertex_path, const char *fragment_path, const std::string &defines)
+{
+    auto start = Clock::now();
+    if (pending.empty())
+        firstSubmit = start;
+
+    // Create the shader directly inside the map to avoid copies, the name points at the map's key
+    auto entry = shaderMap.emplace(shaderName, Shader(nullptr, vertex_path, fragment_path, defines)).first;
+    Shader &shader = entry->second;
+    shader.Name = entry->first.c_str();
+    pending.push_back(&shader);
+    compiler.Submit(shader, &cache, shaderName);
+
+    mainThreadMilliseconds += elapsedMs(start);
+    return shader;
+}
+
+bool ShaderManager::poll(Shader &shader)
+{
+    // anything no longer pending was reported ready, shader.ready may belong to the worker until then
+    if (std::find(pending.begin(), pending.end(), &shader) == pending.end())
+        return true;
+
+    auto start = Clock::now();
+    bool ready = compiler.Poll(shader);
+    mainThreadMilliseconds += elapsedMs(start);
+    if (ready)
+        completed(shader);
+    return ready;
+}
+
+void ShaderManager::wait(Shader &shader)
+{
+    if (std::find(pending.begin(), pending.end(), &shader) == pending.end())
+        return;
+
+    auto start = Clock::now();
+    compiler.Wait(shader);
+    double ms = elapsedMs(start);
+    mainThreadMilliseconds += ms;
+    if (ms > 1.0)
+        std::cout << "[ShaderManager] Waited " << ms << " ms for shader program " << shader.Name << std::endl;
+    completed(shader);
+}
+
+void ShaderManager::completed(Shader &shader)
+{
+    auto it = std::find(pending.begin(), pending.end(), &shader);
+    if (it == pending.end())
+        return;
+    pending.erase(it);
+    (shader.cached ? cacheHits : cacheMisses)++;
+
+    if (pending.empty())
+        std::cout << "[ShaderManager] All " << shaderMap.size() << " shader programs ready "
+                  << elapsedMs(firstSubmit) << " ms after submitting them" << std::endl;
+}
+
+void ShaderManager::Update()
+{
+    // finishing a program on the main thread is quick once the driver reports it done
+    for (size_t i = 0; i < pending.size();)
+    {
+        Shader *shader = pending[i];
+        if (!poll(*shader))
+            i++;
+    }
 }
 
 Shader &ShaderManager::findShader(const std::string &shaderName)
@@ -26,11 +172,13 @@ Shader &ShaderManager::findShader(const std::string &shaderName)
     try
     {
         // .at() is a fast lookup and throws an exception if not found
-        return shaderMap.at(shaderName);
+        Shader &shader = shaderMap.at(shaderName);
+        wait(shader);
+        return shader;
     }
     catch (const std::out_of_range &e)
     {
         std::cerr << "[ShaderManager] Shader program with name: " << shaderName << " not found!" << std::endl;
         throw; // Re-throw the exception
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,121 @@
+#include "BufferObjects/StreamBuffer.h"
+#include "GLExtensions.h"
+#include "GLState.h"
+
+StreamBuffer::StreamBuffer(size_t segmentSize) : segmentSize(segmentSize)
+{
+}
+
+StreamBuffer::~StreamBuffer()
+{
+    destroy();
+}
+
+void StreamBuffer::create()
+{
+    const size_t total = segmentSize * FRAMES;
+    persistent = GLExtensions::bufferStorage;
+
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    if (persistent)
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLExtensions::BufferStorage(GL_COPY_WRITE_BUFFER, total, nullptr, flags);
+        mapped = static_cast<char *>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, total, flags));
+        if (!mapped)
+        {
+            std::cerr << "[StreamBuffer - ERROR] Persistent map failed, falling back to per-allocation maps" << std::endl;
+            GLState::DeleteBuffer(buffer);
+            glGenBuffers(1, &buffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+            persistent = false;
+        }
+    }
+    if (!persistent)
+        glBufferData(GL_COPY_WRITE_BUFFER, total, nullptr, GL_STREAM_DRAW);
+
+    std::cout << "[StreamBuffer] " << (total >> 20) << " MB ring, " << (persistent ? "persistent" : "unsynchronized") << " mapping" << std::endl;
+}
+
+void StreamBuffer::destroy()
+{
+    for (GLsync &fence : fences)
+    {
+        if (fence)
+            glDeleteSync(fence);
+        fence = nullptr;
+    }
+    // deleting the buffer also drops a persistent mapping
+    GLState::DeleteBuffer(buffer);
+    buffer = 0;
+    mapped = nullptr;
+}
+
+void StreamBuffer::BeginFrame()
+{
+    if (!buffer)
+        create();
+
+    segment = (segment + 1) % FRAMES;
+    head = segmentStart();
+    frameOpen = true;
+
+    GLsync &fence = fences[segment];
+    if (!fence)
+        return;
+
+    // normally long signalled, FRAMES - 1 frames of latency are allowed
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    while (result == GL_TIMEOUT_EXPIRED)
+        result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+void StreamBuffer::EndFrame()
+{
+    if (!frameOpen)
+        return;
+    fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frameOpen = false;
+}
+
+StreamAllocation StreamBuffer::Allocate(size_t size, size_t alignment)
+{
+    StreamAllocation allocation;
+    if (!frameOpen || size == 0)
+        return allocation;
+
+    size_t offset = (head + alignment - 1) & ~(alignment - 1);
+    if (offset + size > segmentStart() + segmentSize)
+    {
+        // the segments are fixed size, raise segmentSize if this shows up
+        std::cerr << "[StreamBuffer - ERROR] Frame segment of " << segmentSize << " bytes exhausted, dropping " << size << " bytes" << std::endl;
+        return allocation;
+    }
+    head = offset + size;
+
+    allocation.buffer = buffer;
+    allocation.offset = offset;
+    allocation.size = size;
+
+    if (persistent)
+        allocation.data = mapped + offset;
+    else
+    {
+        // the fence on this segment already passed, so no implicit sync is needed
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        allocation.data = glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, size,
+                                           GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+    }
+    return allocation;
+}
+
+void StreamBuffer::Commit(StreamAllocation &allocation)
+{
+    if (!allocation || persistent)
+        return;
+    glBindBuffer(GL_COPY_WRITE_BUFFER, allocation.buffer);
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+}
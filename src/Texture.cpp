@@ -1,4 +1,5 @@
 #include "Texture.h"
+#include "GLState.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -20,50 +21,83 @@ std::string decodeURIComponent(const std::string &str)
 
 Texture::Texture(const char *filePath, GLenum textureType, unsigned int textureUnit, const std::string &typeName)
 {
-    std::string decodedPath = decodeURIComponent(filePath);
+    this->textureType = textureType;
+    this->textureUnit = textureUnit;
+    this->path = decodeURIComponent(filePath);
+    this->type = typeName;
 
+    TextureImage image;
+    Decode(filePath, image);
+    Upload(image);
+    FreeImage(image);
+}
+
+Texture::Texture(const std::string &filePath, const TextureImage &image, GLenum textureType, unsigned int textureUnit, const std::string &typeName)
+{
     this->textureType = textureType;
     this->textureUnit = textureUnit;
-    this->path = decodedPath;
+    this->path = decodeURIComponent(filePath);
     this->type = typeName;
 
+    Upload(image);
+}
+
+Texture Texture::withBinding(unsigned int textureUnit, const std::string &typeName) const
+{
+    Texture texture = *this;
+    texture.textureUnit = textureUnit;
+    texture.type = typeName;
+    return texture;
+}
+
+bool Texture::Decode(const std::string &filePath, TextureImage &image)
+{
+    std::string decodedPath = decodeURIComponent(filePath);
+
+    image.pixels = stbi_load(decodedPath.c_str(), &image.width, &image.height, &image.channels, 0);
+    if (!image.pixels)
+    {
+        std::cerr << "[Texture - ERROR] Failed to load: " << decodedPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void Texture::FreeImage(TextureImage &image)
+{
+    if (image.pixels)
+        stbi_image_free(image.pixels);
+    image.pixels = nullptr;
+}
+
+void Texture::Upload(const TextureImage &image)
+{
     glGenTextures(1, &ID);
-    glBindTexture(textureType, ID);
+    GLState::BindTexture(textureType, ID);
 
     glTexParameteri(textureType, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(textureType, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
     glTexParameteri(textureType, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
     glTexParameteri(textureType, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
-    int width, height, nrChannels;
-    unsigned char *data = stbi_load(decodedPath.c_str(), &width, &height, &nrChannels, 0);
-
-    GLenum format = (nrChannels == 4) ? GL_RGBA : GL_RGB;
-
-    if (!data)
-    {
-        std::cerr << "[Texture - ERROR] Failed to load: " << decodedPath << std::endl;
+    if (!image.pixels)
         return;
-    }
 
-    stbi_set_flip_vertically_on_load(false);
+    GLenum format = (image.channels == 4) ? GL_RGBA : GL_RGB;
 
-    glTexImage2D(textureType, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+    glTexImage2D(textureType, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels);
     glGenerateMipmap(textureType);
-
-    stbi_image_free(data);
 }
 
 void Texture::Bind(unsigned int texSlot)
 {
-    glActiveTexture(GL_TEXTURE0 + texSlot);
-    glBindTexture(textureType, ID);
+    GLState::BindTexture(texSlot, textureType, ID);
 }
 
 void Texture::SetUniform(Shader &shader, const std::string &uniformName)
 {
     shader.use(); // Optional, only if not already active
-    int loc = glGetUniformLocation(shader.ID, uniformName.c_str());
+    int loc = shader.getUniformLocation(uniformName);
     if (loc == -1)
     {
         std::cerr << "[Texture - ERROR] Uniform '" << uniformName << "' not found in shader." << std::endl;
@@ -74,5 +108,5 @@ void Texture::SetUniform(Shader &shader, const std::string &uniformName)
 
 void Texture::UnBind()
 {
-    glBindTexture(textureType, 0);
+    GLState::BindTexture(textureType, 0);
 }
\ No newline at end of file
@@ -0,0 +1,310 @@
+#include "TransformStore.h"
+
+#include <algorithm>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/euler_angles.hpp>
+#include <glm/gtx/matrix_decompose.hpp>
+
+namespace
+{
+    const glm::mat4 IDENTITY = glm::mat4(1.f);
+    const glm::mat3 IDENTITY_NORMAL = glm::mat3(1.f);
+
+    // translate * rotX * rotY * rotZ * scale, without going through glm::rotate three times
+    glm::mat4 composeTRS(const glm::vec3 &position, const glm::vec3 &rotation, const glm::vec3 &scale)
+    {
+        glm::mat4 m = glm::eulerAngleXYZ(rotation.x, rotation.y, rotation.z);
+        m[0] *= scale.x;
+        m[1] *= scale.y;
+        m[2] *= scale.z;
+        m[3] = glm::vec4(position, 1.f);
+        return m;
+    }
+}
+
+void TransformStore::add(unsigned int nodeID, unsigned int parentID)
+{
+    if (nodeID >= indexByNode.size())
+        indexByNode.resize(nodeID + 1, NONE);
+
+    uint32_t index = static_cast<uint32_t>(nodeIDs.size());
+    indexByNode[nodeID] = index;
+
+    // appending keeps the order valid: the parent is already somewhere before us
+    nodeIDs.push_back(nodeID);
+    parents.push_back(parentID == NONE ? NONE : indexOf(parentID));
+    positions.push_back(glm::vec3(0.f));
+    rotations.push_back(glm::vec3(0.f));
+    scales.push_back(glm::vec3(1.f));
+    worldMatrices.push_back(glm::mat4(1.f));
+    normalMatrices.push_back(glm::mat3(1.f));
+    localDirty.push_back(1);
+    worldChanged.push_back(0);
+}
+
+void TransformStore::remove(unsigned int nodeID)
+{
+    uint32_t index = indexOf(nodeID);
+    if (index == NONE)
+        return;
+
+    // compacted away by the next flatten()
+    nodeIDs[index] = NONE;
+    indexByNode[nodeID] = NONE;
+    needsFlatten = true;
+}
+
+void TransformStore::setParent(unsigned int nodeID, unsigned int parentID)
+{
+    uint32_t index = indexOf(nodeID);
+    if (index == NONE)
+        return;
+
+    parents[index] = parentID == NONE ? NONE : indexOf(parentID);
+    localDirty[index] = 1;
+    needsFlatten = true;
+}
+
+void TransformStore::clear()
+{
+    nodeIDs.clear();
+    parents.clear();
+    positions.clear();
+    rotations.clear();
+    scales.clear();
+    worldMatrices.clear();
+    normalMatrices.clear();
+    localDirty.clear();
+    worldChanged.clear();
+    indexByNode.clear();
+    needsFlatten = false;
+}
+
+bool TransformStore::contains(unsigned int nodeID) const
+{
+    return indexOf(nodeID) != NONE;
+}
+
+uint32_t TransformStore::indexOf(unsigned int nodeID) const
+{
+    if (nodeID >= indexByNode.size())
+        return NONE;
+    return indexByNode[nodeID];
+}
+
+void TransformStore::setPosition(unsigned int nodeID, const glm::vec3 &position)
+{
+    uint32_t index = indexOf(nodeID);
+    if (index != NONE && positions[index] != position)
+    {
+        positions[index] = position;
+        localDirty[index] = 1;
+    }
+}
+
+void TransformStore::setRotation(unsigned int nodeID, const glm::vec3 &rotation)
+{
+    uint32_t index = indexOf(nodeID);
+    if (index != NONE && rotations[index] != rotation)
+    {
+        rotations[index] = rotation;
+        localDirty[index] = 1;
+    }
+}
+
+void TransformStore::setScale(unsigned int nodeID, const glm::vec3 &scale)
+{
+    uint32_t index = indexOf(nodeID);
+    if (index != NONE && scales[index] != scale)
+    {
+        scales[index] = scale;
+        localDirty[index] = 1;
+    }
+}
+
+glm::vec3 TransformStore::getPosition(unsigned int nodeID) const
+{
+    uint32_t index = indexOf(nodeID);
+    return index != NONE ? positions[index] : glm::vec3(0.f);
+}
+
+glm::vec3 TransformStore::getRotation(unsigned int nodeID) const
+{
+    uint32_t index = indexOf(nodeID);
+    return index != NONE ? rotations[index] : glm::vec3(0.f);
+}
+
+glm::vec3 TransformStore::getScale(unsigned int nodeID) const
+{
+    uint32_t index = indexOf(nodeID);
+    return index != NONE ? scales[index] : glm::vec3(1.f);
+}
+
+const glm::mat4 &TransformStore::getWorldMatrix(unsigned int nodeID) const
+{
+    uint32_t index = indexOf(nodeID);
+    return index != NONE ? worldMatrices[index] : IDENTITY;
+}
+
+const glm::mat3 &TransformStore::getNormalMatrix(unsigned int nodeID) const
+{
+    uint32_t index = indexOf(nodeID);
+    return index != NONE ? normalMatrices[index] : IDENTITY_NORMAL;
+}
+
+bool TransformStore::wasUpdated(unsigned int nodeID) const
+{
+    uint32_t index = indexOf(nodeID);
+    return index != NONE && worldChanged[index];
+}
+
+glm::vec3 TransformStore::getWorldPosition(unsigned int nodeID) const
+{
+    return glm::vec3(getWorldMatrix(nodeID)[3]);
+}
+
+void TransformStore::setWorldMatrix(unsigned int nodeID, const glm::mat4 &world)
+{
+    uint32_t index = indexOf(nodeID);
+    if (index == NONE)
+        return;
+
+    uint32_t parent = parents[index];
+    glm::mat4 local = parent == NONE ? world : glm::inverse(worldMatrices[parent]) * world;
+
+    glm::vec3 scale, translation, skew;
+    glm::vec4 perspective;
+    glm::quat orientation;
+    if (!glm::decompose(local, scale, orientation, translation, skew, perspective))
+        return;
+
+    glm::vec3 euler;
+    glm::extractEulerAngleXYZ(glm::mat4_cast(orientation), euler.x, euler.y, euler.z);
+
+    // physics transforms carry no scale, the node keeps the one it was given
+    positions[index] = translation;
+    rotations[index] = euler;
+    localDirty[index] = 1;
+}
+
+void TransformStore::update()
+{
+    if (needsFlatten)
+        flatten();
+
+    stats = {};
+
+    const size_t count = nodeIDs.size();
+    for (size_t i = 0; i < count; i++)
+    {
+        uint32_t parent = parents[i];
+
+        // parents come first, so their changed flag for this frame is already final
+        bool changed = localDirty[i] || (parent != NONE && worldChanged[parent]);
+        worldChanged[i] = changed;
+        if (!changed)
+        {
+            stats.skipped++;
+            continue;
+        }
+
+        glm::mat4 local = composeTRS(positions[i], rotations[i], scales[i]);
+        worldMatrices[i] = parent == NONE ? local : worldMatrices[parent] * local;
+        normalMatrices[i] = glm::transpose(glm::inverse(glm::mat3(worldMatrices[i])));
+        localDirty[i] = 0;
+        stats.recomputed++;
+    }
+}
+
+// Drops removed entries and re-sorts everything breadth-first (stable by depth),
+// which restores the parent-before-child order after reparenting.
+void TransformStore::flatten()
+{
+    const uint32_t count = static_cast<uint32_t>(nodeIDs.size());
+
+    // depth of every live entry, orphans of removed parents become roots
+    std::vector<uint32_t> depth(count, NONE);
+    std::vector<uint32_t> chain;
+    uint32_t maxDepth = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (nodeIDs[i] == NONE || depth[i] != NONE)
+            continue;
+
+        uint32_t cursor = i;
+        while (cursor != NONE && depth[cursor] == NONE)
+        {
+            chain.push_back(cursor);
+            uint32_t parent = parents[cursor];
+            if (parent != NONE && nodeIDs[parent] == NONE)
+            {
+                parents[cursor] = parent = NONE;
+                localDirty[cursor] = 1;
+            }
+            cursor = parent;
+        }
+
+        uint32_t d = cursor == NONE ? 0 : depth[cursor] + 1;
+        while (!chain.empty())
+        {
+            depth[chain.back()] = d++;
+            chain.pop_back();
+        }
+        maxDepth = std::max(maxDepth, d);
+    }
+
+    // counting sort by depth, maxDepth is the number of levels here
+    std::vector<uint32_t> levelStart(maxDepth + 1, 0);
+    for (uint32_t i = 0; i < count; i++)
+        if (nodeIDs[i] != NONE)
+            levelStart[depth[i] + 1]++;
+    for (uint32_t d = 1; d <= maxDepth; d++)
+        levelStart[d] += levelStart[d - 1];
+
+    std::vector<uint32_t> newIndex(count, NONE);
+    uint32_t liveCount = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (nodeIDs[i] == NONE)
+            continue;
+        newIndex[i] = levelStart[depth[i]]++;
+        liveCount++;
+    }
+
+    std::vector<unsigned int> newNodeIDs(liveCount);
+    std::vector<uint32_t> newParents(liveCount);
+    std::vector<glm::vec3> newPositions(liveCount), newRotations(liveCount), newScales(liveCount);
+    std::vector<glm::mat4> newWorlds(liveCount);
+    std::vector<glm::mat3> newNormals(liveCount);
+    std::vector<uint8_t> newLocalDirty(liveCount), newWorldChanged(liveCount);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint32_t n = newIndex[i];
+        if (n == NONE)
+            continue;
+        newNodeIDs[n] = nodeIDs[i];
+        newParents[n] = parents[i] == NONE ? NONE : newIndex[parents[i]];
+        newPositions[n] = positions[i];
+        newRotations[n] = rotations[i];
+        newScales[n] = scales[i];
+        newWorlds[n] = worldMatrices[i];
+        newNormals[n] = normalMatrices[i];
+        newLocalDirty[n] = localDirty[i];
+        newWorldChanged[n] = worldChanged[i];
+        indexByNode[nodeIDs[i]] = n;
+    }
+
+    nodeIDs.swap(newNodeIDs);
+    parents.swap(newParents);
+    positions.swap(newPositions);
+    rotations.swap(newRotations);
+    scales.swap(newScales);
+    worldMatrices.swap(newWorlds);
+    normalMatrices.swap(newNormals);
+    localDirty.swap(newLocalDirty);
+    worldChanged.swap(newWorldChanged);
+
+    needsFlatten = false;
+}
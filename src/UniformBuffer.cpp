@@ -0,0 +1,26 @@
+#include "BufferObjects/UniformBuffer.h"
+#include "GLState.h"
+
+UniformBuffer::UniformBuffer(unsigned int size, unsigned int bindingPoint) : bindingPoint(bindingPoint)
+{
+    glGenBuffers(1, &ID);
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, ID);
+    glBufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, ID);
+}
+
+void UniformBuffer::SetData(const void *data, unsigned int size, unsigned int offset)
+{
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, ID);
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, size, data);
+}
+
+void UniformBuffer::Bind()
+{
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, ID);
+}
+
+void UniformBuffer::UnBind()
+{
+    GLState::BindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -1,9 +1,10 @@
 #include "BufferObjects/VertexArray.h"
+#include "GLState.h"
 
 VertexArray::VertexArray()
 {
     glGenVertexArrays(1, &ID);
-    glBindVertexArray(ID);
+    GLState::BindVertexArray(ID);
 }
 
 // Index = attribute location (e.g., 0)
@@ -16,10 +17,10 @@ void VertexArray::AddAttribLayout(unsigned int index, int count, GLenum type, GL
 
 void VertexArray::Bind()
 {
-    glBindVertexArray(ID);
+    GLState::BindVertexArray(ID);
 }
 
 void VertexArray::UnBind()
 {
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLState::BindVertexArray(0);
 }
\ No newline at end of file
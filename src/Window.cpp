@@ -1,10 +1,13 @@
 #include "Window.h"
+#include "GLExtensions.h"
 
 using namespace std;
 
 void framebuffer_size_callback(GLFWwindow *window, int width, int height)
 {
-    glViewport(0, 0, width, height);
+    // with a render thread the context is not current here, it sets the viewport from the frame packet
+    if (glfwGetCurrentContext() == window)
+        glViewport(0, 0, width, height);
 }
 
 Window::Window(const char *title)
@@ -29,13 +32,54 @@ Window::Window(const char *title)
     glfwMaximizeWindow(window);
     glfwMakeContextCurrent(window);
 
-    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    if (!loadGL())
+        return;
+
+    Window::setViewport();
+}
+
+Window::Window(const char *title, int width, int height)
+{
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    // EGL without a surface is the GPU path, OSMesa (llvmpipe) works on any machine
+    const int contextAPIs[2] = {GLFW_EGL_CONTEXT_API, GLFW_OSMESA_CONTEXT_API};
+    for (int api : contextAPIs)
     {
-        cout << "[Window - ERROR] Failed to initialize GLAD" << endl;
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, api);
+        window = glfwCreateWindow(width, height, title, NULL, NULL);
+        if (window)
+            break;
+    }
+    if (window == NULL)
+    {
+        cout << "[Window - ERROR] Failed to create a headless context (EGL or OSMesa)" << endl;
         return;
     }
+    cout << "[FYNiX] Launching FYNiX headless, " << width << "x" << height << " offscreen." << endl;
 
-    Window::setViewport();
+    glfwMakeContextCurrent(window);
+    if (!loadGL())
+    {
+        glfwDestroyWindow(window);
+        window = nullptr;
+        return;
+    }
+    glViewport(0, 0, width, height);
+}
+
+bool Window::loadGL()
+{
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+    {
+        cout << "[Window - ERROR] Failed to initialize GLAD" << endl;
+        return false;
+    }
+    GLExtensions::Load();
+    return true;
 }
 
 void Window::setViewport()
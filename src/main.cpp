@@ -1,5 +1,9 @@
 // default cpp includes
 #include <iostream>
+#include <chrono>
+#include <thread>
+#include <cstdio>
+#include <filesystem>
 #include <windows.h>
 #include <dirent.h>
 
@@ -26,6 +30,14 @@
 
 #include "PhysicsEngine.h"
 
+#include "ModelImporter.h"
+#include "FMesh.h"
+#include "GLState.h"
+#include "GBuffer.h"
+#include "RenderThread.h"
+#include "OffscreenTarget.h"
+#include "Headless.h"
+
 using namespace std;
 
 extern "C"
@@ -118,16 +130,64 @@ std::string FindFynxProjectFile(const std::string &folderPath)
     return "";
 }
 
-int main()
+// bakes .fmesh files next to the given models, always from the source
+int cookModels(int count, char **paths)
+{
+    int failed = 0;
+    for (int i = 0; i < count; i++)
+    {
+        ModelData data;
+        ModelImporter importer;
+        if (!importer.import(paths[i], data) || !FMesh::write(FMesh::cookedPath(paths[i]), paths[i], data))
+        {
+            std::cerr << "[FYNiX] Could not cook " << paths[i] << std::endl;
+            failed++;
+        }
+    }
+    return failed == 0 ? 0 : -1;
+}
+
+int main(int argc, char **argv)
 {
-    std::string path = FindFynxProjectFile("Projects/Load_Project");
+    auto launchTime = std::chrono::high_resolution_clock::now();
+
+    // fynix --cook assets/world.glb assets/running_guy.gltf ...
+    if (argc > 1 && std::string(argv[1]) == "--cook")
+        return cookModels(argc - 2, argv + 2);
+
+    // fynix --deferred: models are shaded through a G-buffer instead of the forward shader
+    // fynix --single-thread: update and GL submission on the main thread, one after the other
+    // fynix --scene path.fynx: instead of the first .fynx in Projects/Load_Project
+    // fynix --headless ...: offscreen benchmark run, see Headless.h
+    bool deferred = false, singleThread = std::thread::hardware_concurrency() < 2;
+    std::string path;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::string(argv[i]) == "--deferred")
+            deferred = true;
+        else if (std::string(argv[i]) == "--single-thread")
+            singleThread = true;
+        else if (std::string(argv[i]) == "--scene" && i + 1 < argc)
+            path = argv[++i];
+    }
+
+    HeadlessOptions headless;
+    if (!headless.parse(argc, argv))
+        return -1;
+
+    if (path.empty())
+        path = FindFynxProjectFile("Projects/Load_Project");
     if (path.empty())
     {
         std::cerr << "[FYNiX] No .fynx file found." << std::endl;
-        getchar();
+        if (!headless.enabled)
+            getchar();
         return -1;
     }
 
+    // the null platform needs no display, the context comes from EGL or OSMesa
+    if (headless.enabled)
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
     if (!glfwInit())
     {
         cout << "Failed to initialize GLFW" << endl;
@@ -135,62 +195,195 @@ int main()
     }
 
     std::string projectName = "[" + path.substr(path.find_last_of('/') + 1) + "] FYNiX - Framework for Yet-to-be Named eXperiences";
-    Window windowManager((char *)projectName.c_str());
-    GLFWwindow *window = windowManager.getWindowObject();
+    std::unique_ptr<Window> windowManager = headless.enabled
+                                                ? std::make_unique<Window>(projectName.c_str(), headless.width, headless.height)
+                                                : std::make_unique<Window>(projectName.c_str());
+    GLFWwindow *window = windowManager->getWindowObject();
+    if (!window)
+    {
+        glfwTerminate();
+        return -1;
+    }
+    const int viewWidth = headless.enabled ? headless.width : windowManager->mode->width;
+    const int viewHeight = headless.enabled ? headless.height : windowManager->mode->height;
 
     SceneManager scene(path);
 
-    GUIManager gui(windowManager.getWindowObject(), scene, windowManager.mode->width, windowManager.mode->height);
+    // headless runs have no GUI and no input, the camera stays where it starts
+    std::unique_ptr<GUIManager> gui;
+    if (!headless.enabled)
+        gui = std::make_unique<GUIManager>(window, scene, viewWidth, viewHeight);
 
     glm::mat4 view = glm::mat4(1.f);
     Camera cam(&view);
     globalCamera = &cam;
 
-    glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    if (!headless.enabled)
+    {
+        glfwSetCursorPosCallback(window, mouse_callback);
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    }
 
     glEnable(GL_DEPTH_TEST);
 
+    // stands in for the back buffer when there is no window
+    OffscreenTarget offscreen;
+    if (headless.enabled && !offscreen.Create(headless.width, headless.height))
+    {
+        glfwTerminate();
+        return -1;
+    }
+
     ShaderManager sm;
     scene.sm = &sm;
+    scene.deferredShading = deferred;
 
-    sm.addShader("light", "shaders/light/vertex.glsl", "shaders/light/fragment.glsl"),
-        sm.addShader("default", "shaders/model/vertex.glsl", "shaders/model/fragment.glsl"),
+    // everything is submitted first and compiles in the background, the fallback goes first
+    // since models are drawn with it until their variants are in
+    sm.addShader(FALLBACK_SHADER, "shaders/fallback/vertex.glsl", "shaders/fallback/fragment.glsl"),
+        sm.addShader("light", "shaders/light/vertex.glsl", "shaders/light/fragment.glsl"),
         sm.addShader("particle", "shaders/particles/particles.vert", "shaders/particles/particles.frag");
+    sm.addShaderVariants("default", "shaders/model/vertex.glsl", "shaders/model/fragment.glsl",
+                         SHADER_SKINNED | SHADER_TEXTURED | SHADER_CLUSTERED_LIGHTS);
 
-    Shader lightShader = sm.findShader("light"),
-           particleShader = sm.findShader("particle"),
-           defaultShader = sm.findShader("default");
+    // same scene submission as the forward path, only the model shader and the targets change
+    GBuffer gbuffer;
+    if (deferred)
+    {
+        sm.addShaderVariants("gbuffer", "shaders/model/vertex.glsl", "shaders/deferred/gbuffer.frag", SHADER_SKINNED | SHADER_TEXTURED);
+        sm.addShaderVariants("deferred", "shaders/deferred/lighting.vert", "shaders/deferred/lighting.frag", SHADER_CLUSTERED_LIGHTS);
+        cout << "[FYNiX] Deferred shading enabled." << endl;
+    }
 
     sm.listShaders();
+    sm.printStats();
 
-    defaultShader.use();
-
-    glm::mat4 model = glm::mat4(0.f);
     glm::mat4 projection = glm::mat4(0.f);
-    projection = glm::perspective(glm::radians(45.f), (float)(windowManager.mode->width / windowManager.mode->height), 0.1f, 100.f);
-
-    defaultShader.setUniforms("model", static_cast<unsigned int>(UniformType::Mat4f), (void *)glm::value_ptr(model));
-    defaultShader.setUniforms("view", static_cast<unsigned int>(UniformType::Mat4f), (void *)glm::value_ptr(view));
-    defaultShader.setUniforms("projection", static_cast<unsigned int>(UniformType::Mat4f), (void *)glm::value_ptr(projection));
+    projection = glm::perspective(glm::radians(45.f), static_cast<float>(viewWidth) / viewHeight, 0.1f, 100.f);
 
     scene.LoadScene(path);
 
-    lightShader.use();
+    // first use, waits for the program if it is still compiling
+    Shader &lightShader = sm.findShader("light");
 
-    lightShader.setUniforms("view", static_cast<unsigned int>(UniformType::Mat4f), (void *)glm::value_ptr(view));
-    lightShader.setUniforms("projection", static_cast<unsigned int>(UniformType::Mat4f), (void *)glm::value_ptr(projection));
+    // timed frames start from a fully loaded scene with every program built, so runs compare
+    if (headless.enabled)
+    {
+        srand(1);
+        while (scene.assets.loadingCount() > 0 || sm.compilingCount() > 0)
+        {
+            if (scene.assets.hasPendingUploads())
+                scene.assets.processUploads();
+            else
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            sm.Update();
+        }
+        cout << "[Headless] Scene loaded after "
+             << std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - launchTime).count() << " ms" << endl;
 
-    particleShader.use();
+        std::error_code ec;
+        if (!headless.dumpDirectory.empty())
+            std::filesystem::create_directories(headless.dumpDirectory, ec);
+    }
+    TimingLog timings(headless.enabled ? headless.frames : 0);
+    std::vector<unsigned char> framePixels;
+
+    // everything GL of a frame, on the render thread when there is one
+    bool firstFrame = true;
+    RenderThread renderThread;
+    renderThread.SetDrawFunction([&](FramePacket &packet)
+                                 {
+        auto renderStart = std::chrono::high_resolution_clock::now();
+        const unsigned int target = headless.enabled ? offscreen.getFramebuffer() : 0;
+        glBindFramebuffer(GL_FRAMEBUFFER, target);
+        glViewport(0, 0, packet.framebufferWidth, packet.framebufferHeight);
+        sm.Update();
+        scene.BeginFrame(packet);
+
+        glClearColor(0.05f, 0.05f, 0.05f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    particleShader.setUniforms("view", static_cast<unsigned int>(UniformType::Mat4f), (void *)glm::value_ptr(view));
-    particleShader.setUniforms("projection", static_cast<unsigned int>(UniformType::Mat4f), (void *)glm::value_ptr(projection));
+        if (!packet.modelDraws.empty())
+        {
+            if (deferred)
+            {
+                gbuffer.Begin(packet.framebufferWidth, packet.framebufferHeight);
+                scene.RenderModels(packet, "gbuffer");
+                gbuffer.End(target);
+                scene.RenderDeferredLighting(packet, "deferred", gbuffer);
+            }
+            else
+                scene.RenderModels(packet, "default");
+        }
+        if (!packet.lightGizmos.empty())
+            scene.RenderLights(packet, lightShader);
+        if (!packet.particleBatches.empty())
+            scene.RenderParticles(packet);
+        if (!packet.physicsShapes.empty())
+            scene.RenderPhysics(packet, lightShader);
+
+        GUIManager::Render(packet.gui);
+        GLState::EndFrame();
+        scene.EndFrame();
+
+        if (headless.enabled)
+        {
+            timings[packet.frameNumber].renderMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - renderStart).count();
+            if (!headless.dumpDirectory.empty())
+            {
+                char name[32];
+                snprintf(name, sizeof(name), "/frame_%05llu.ppm", static_cast<unsigned long long>(packet.frameNumber));
+                offscreen.ReadPixels(framePixels);
+                OffscreenTarget::WritePPM(headless.dumpDirectory + name, offscreen.getWidth(), offscreen.getHeight(), framePixels);
+            }
+        }
+        else
+        {
+            //===== SWAP BUFFERS =====
+            glfwSwapBuffers(window);
+        }
+
+        if (firstFrame)
+        {
+            firstFrame = false;
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - launchTime).count();
+            cout << "[FYNiX] First frame after " << ms << " ms, " << sm.compilingCount() << " shader programs still compiling" << endl;
+            sm.printStats();
+        } });
+
+    // from here on the main thread only updates, frame N+1 is simulated while frame N is drawn
+    if (!singleThread)
+    {
+        renderThread.Start(window);
+        scene.renderThread = &renderThread;
+    }
 
     cout << "[FYNiX] FYNiX: Framework for Yet-to-be Named eXperiences is ready!" << endl;
 
+    // headless: a fixed number of frames with a fixed step, as fast as they can be drawn
+    using Clock = std::chrono::high_resolution_clock;
+    auto msSince = [](Clock::time_point start)
+    { return std::chrono::duration<double, std::milli>(Clock::now() - start).count(); };
+    for (int frame = 0; headless.enabled && frame < headless.frames; frame++)
+    {
+        auto frameStart = Clock::now();
+        FramePacket &packet = renderThread.BeginPacket();
+        timings[frame].waitMs = msSince(frameStart);
+        auto updateStart = Clock::now();
+
+        scene.Update(headless.timestep);
+        packet.framebufferWidth = headless.width;
+        packet.framebufferHeight = headless.height;
+        scene.BuildFramePacket(packet, view, projection, cam.camPos);
+        timings[frame].updateMs = msSince(updateStart);
+
+        renderThread.SubmitPacket();
+        timings[frame].frameMs = msSince(frameStart);
+    }
+
     float deltaTime = 0.0f, lastFrame = 0.0f;
 
-    while (!glfwWindowShouldClose(window))
+    while (!headless.enabled && !glfwWindowShouldClose(window))
     {
         glfwPollEvents();
         // ==== DELTA TIME ====
@@ -198,42 +391,37 @@ int main()
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
+        // waits only while the render thread is still drawing the packet this reuses
+        FramePacket &packet = renderThread.BeginPacket();
+
         // ===== GUI SECTION ===
-        gui.Start();
+        gui->Start();
 
         //===== INPUT SECTION =====
         inputHandler(window, deltaTime, globalCamera ? *globalCamera : cam);
-        defaultShader.use();
-        defaultShader.setUniforms("view", static_cast<unsigned int>(UniformType::Mat4f), (void *)glm::value_ptr(view));
-        defaultShader.setUniforms("uCamPos", static_cast<unsigned int>(UniformType::Vec3f), (void *)glm::value_ptr(globalCamera ? globalCamera->camPos : cam.camPos));
-
-        lightShader.use();
-        lightShader.setUniforms("view", static_cast<unsigned int>(UniformType::Mat4f), (void *)glm::value_ptr(view));
 
-        particleShader.use();
-        particleShader.setUniforms("view", static_cast<unsigned int>(UniformType::Mat4f), (void *)glm::value_ptr(view));
+        //===== UPDATE SECTION =====
+        scene.Update(deltaTime);
 
-        //===== RENDER SECTION =====
-        glClearColor(0.05f, 0.05f, 0.05f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        glfwGetFramebufferSize(window, &packet.framebufferWidth, &packet.framebufferHeight);
+        scene.BuildFramePacket(packet, view, projection, globalCamera ? globalCamera->camPos : cam.camPos);
+        gui->EndFrame(packet.gui);
 
-        defaultShader.use();
+        // drawn right here without a render thread
+        renderThread.SubmitPacket();
+    }
 
-        if (scene.models.size() > 0)
-            scene.RenderModels(defaultShader, deltaTime);
-        if (scene.lights.size() > 0)
-            scene.RenderLights(lightShader);
-        if (scene.particleEmitters.size() > 0)
-            scene.RenderParticles(deltaTime);
-        if (scene.rigidBodies.size() > 0)
-            scene.RenderPhysics(deltaTime, lightShader);
+    // the remaining frames are drawn and the context comes back for the cleanup below
+    renderThread.Stop();
+    scene.renderThread = nullptr;
 
-        gui.Render();
-        //===== SWAP BUFFERS AND POLL EVENTS ===
-        glfwSwapBuffers(window);
-    }
+    int result = 0;
+    if (headless.enabled && !timings.write(headless.timingsPath, headless, path, !singleThread, deferred))
+        result = -1;
 
-    gui.Shutdown();
+    if (gui)
+        gui->Shutdown();
+    sm.Shutdown();
     glfwTerminate();
-    return 0;
+    return result;
 }
\ No newline at end of file